@@ -0,0 +1,200 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <bitset>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define AGEKERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AGEKERNELS_AVX2
+#else
+#define AGEKERNELS_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// 年龄列统计结果（只统计 [lo, hi] 内的值；列中 0 表示空行）
+struct AgeStats {
+    size_t count = 0;
+    int min = 0;
+    int max = 0;
+    uint64_t sum = 0;
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+};
+
+// 连续年龄列（uint8，按行号存放）上的过滤与聚合内核
+// 运行时检测 AVX2：支持则每次处理 32 行，否则走标量实现
+class AgeKernels {
+public:
+    // 整列统计
+    static AgeStats aggregate(const uint8_t* ages, size_t n, int lo, int hi) {
+        return aggregateMasked(ages, n, nullptr, 0, lo, hi);
+    }
+
+    // 按行号位图过滤后统计（mask 第 i 位对应第 i 行；mask 为空表示不过滤）
+    static AgeStats aggregateMasked(const uint8_t* ages, size_t n, const uint64_t* mask, size_t maskWords,
+                                    int lo, int hi) {
+        if (!clampRange(n, mask, maskWords, lo, hi)) return AgeStats();
+#ifdef AGEKERNELS_X86
+        if (hasAvx2()) return aggregateAvx2(ages, n, mask, lo, hi);
+#endif
+        return aggregateScalar(ages, 0, n, mask, lo, hi, AgeStats());
+    }
+
+    // 同 aggregateMasked，固定走标量实现（与向量实现对照、基准测试用）
+    static AgeStats aggregateMaskedScalar(const uint8_t* ages, size_t n, const uint64_t* mask, size_t maskWords,
+                                          int lo, int hi) {
+        if (!clampRange(n, mask, maskWords, lo, hi)) return AgeStats();
+        return aggregateScalar(ages, 0, n, mask, lo, hi, AgeStats());
+    }
+
+    // 整列加上 delta：只改非 0 值（0 是空行或异常值）；调用方保证结果仍在 1-255 内
+    static void shift(uint8_t* ages, size_t n, int delta) {
+        size_t i = 0;
+#ifdef AGEKERNELS_X86
+        if (hasAvx2()) i = shiftAvx2(ages, n, delta);
+#endif
+        shiftRange(ages, i, n, delta);
+    }
+
+    // 同 shift，固定走标量实现
+    static void shiftScalar(uint8_t* ages, size_t n, int delta) {
+        shiftRange(ages, 0, n, delta);
+    }
+
+    static bool hasAvx2() {
+#ifdef AGEKERNELS_X86
+        static const bool supported = detectAvx2();
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+private:
+    // 统计区间收窄到 [1, 255]（0 是空行），有掩码时行数不超过掩码位数；区间为空返回 false
+    static bool clampRange(size_t& n, const uint64_t* mask, size_t maskWords, int& lo, int& hi) {
+        lo = std::max(lo, 1);
+        hi = std::min(hi, 255);
+        if (mask) n = std::min(n, maskWords * 64);
+        return lo <= hi;
+    }
+
+    static void shiftRange(uint8_t* ages, size_t begin, size_t end, int delta) {
+        for (size_t i = begin; i < end; ++i) {
+            if (ages[i]) ages[i] = static_cast<uint8_t>(ages[i] + delta);
+        }
+    }
+
+    static AgeStats aggregateScalar(const uint8_t* ages, size_t begin, size_t end, const uint64_t* mask,
+                                    int lo, int hi, AgeStats acc) {
+        int mn = acc.count ? acc.min : 256;
+        int mx = acc.count ? acc.max : 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (mask && !((mask[i >> 6] >> (i & 63)) & 1)) continue;
+            int a = ages[i];
+            if (a < lo || a > hi) continue;
+            ++acc.count;
+            acc.sum += a;
+            mn = std::min(mn, a);
+            mx = std::max(mx, a);
+        }
+        if (acc.count) {
+            acc.min = mn;
+            acc.max = mx;
+        }
+        return acc;
+    }
+
+#ifdef AGEKERNELS_X86
+    static bool detectAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;  // 操作系统需保存 YMM 寄存器
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    // 32 位行掩码展开为 32 字节（置位行为 0xFF）
+    AGEKERNELS_AVX2 static __m256i expandMask(uint32_t bits) {
+        const __m256i shuffle = _mm256_setr_epi64x(0x0000000000000000LL, 0x0101010101010101LL,
+                                                   0x0202020202020202LL, 0x0303030303030303LL);
+        const __m256i select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+        __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(bits)), shuffle);
+        return _mm256_cmpeq_epi8(_mm256_and_si256(v, select), select);
+    }
+
+    // 返回已处理的行数，余下不足 32 行由标量收尾
+    AGEKERNELS_AVX2 static size_t shiftAvx2(uint8_t* ages, size_t n, int delta) {
+        const __m256i vdelta = _mm256_set1_epi8(static_cast<char>(delta));
+        const __m256i zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ages + i));
+            __m256i empty = _mm256_cmpeq_epi8(x, zero);
+            __m256i add = _mm256_andnot_si256(empty, vdelta);  // 按模 256 相加，负增量同样成立
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(ages + i), _mm256_add_epi8(x, add));
+        }
+        return i;
+    }
+
+    AGEKERNELS_AVX2 static AgeStats aggregateAvx2(const uint8_t* ages, size_t n, const uint64_t* mask,
+                                                  int lo, int hi) {
+        const __m256i vlo = _mm256_set1_epi8(static_cast<char>(lo));
+        const __m256i vhi = _mm256_set1_epi8(static_cast<char>(hi));
+        const __m256i ones = _mm256_set1_epi8(static_cast<char>(0xFF));
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i vmin = ones;
+        __m256i vmax = zero;
+        __m256i vsum = zero;  // 4 个 64 位累加器
+        size_t count = 0;
+
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ages + i));
+            // 无符号比较：x >= lo ⇔ max(x, lo) == x；x <= hi ⇔ min(x, hi) == x
+            __m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(x, vlo), x),
+                                         _mm256_cmpeq_epi8(_mm256_min_epu8(x, vhi), x));
+            if (mask) {
+                uint32_t bits = static_cast<uint32_t>(mask[i >> 6] >> (i & 63));
+                m = _mm256_and_si256(m, expandMask(bits));
+            }
+            uint32_t hit = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+            if (!hit) continue;
+            count += std::bitset<32>(hit).count();
+            __m256i kept = _mm256_and_si256(x, m);
+            vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(kept, zero));
+            vmax = _mm256_max_epu8(vmax, kept);
+            vmin = _mm256_min_epu8(vmin, _mm256_blendv_epi8(ones, x, m));
+        }
+
+        alignas(32) uint8_t mins[32], maxs[32];
+        alignas(32) uint64_t sums[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(mins), vmin);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), vmax);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), vsum);
+
+        AgeStats acc;
+        acc.count = count;
+        acc.sum = sums[0] + sums[1] + sums[2] + sums[3];
+        if (count) {
+            acc.min = *std::min_element(mins, mins + 32);
+            acc.max = *std::max_element(maxs, maxs + 32);
+        }
+        return aggregateScalar(ages, i, n, mask, lo, hi, acc);
+    }
+#endif
+};
@@ -0,0 +1,341 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string_view>
+#include <filesystem>
+#include <cstdint>
+#include "Student.h"
+#include "AgeKernels.h"
+#include "FlatHashMap.h"
+#include "StudentManager.h"
+#include "QueryDsl.h"
+#include "JsonHelper.h"
+
+// 性能对比（--bench [记录数]）：同一批数据分别走新旧实现，输出耗时与校验和，
+// 校验和一致说明两边做了相同的工作
+// 学年升级与年龄内核按整库操作的规模固定为 ROLLOVER_ROWS / AGE_KERNEL_ROWS 行，不随记录数参数变化
+class Benchmark {
+public:
+    static constexpr size_t ROLLOVER_ROWS = 1000000;
+    static constexpr size_t AGE_KERNEL_ROWS = 10000000;
+
+    static void runAll(size_t n) {
+        std::cout << "基准测试：" << n << " 条记录\n";
+        hashTables(n);
+        textLookups(n);
+        queryDsl(n);
+        rollover(ROLLOVER_ROWS);
+        ageKernels(AGE_KERNEL_ROWS);
+    }
+
+    // ========== 哈希表：FlatHashMap 与原先的 unordered_multimap ==========
+    // 值为完整记录，与替换前 学号 → 学生 的存放方式一致
+    static void hashTables(size_t n) {
+        std::vector<Student> records = makeStudents(n);
+        std::vector<std::string> hits, misses;
+        for (const Student& s : records) {
+            hits.push_back(s.xh);
+            misses.push_back("2099" + s.xh.substr(4));
+        }
+        std::shuffle(hits.begin(), hits.end(), std::mt19937(7));
+
+        FlatHashMap<std::string, Student> flat;
+        std::unordered_multimap<std::string, Student> node;
+        size_t sumFlat = 0, sumNode = 0;
+
+        header("哈希表", "FlatHashMap", "unordered_multimap");
+        report("录入",
+            timeMs([&] { for (const Student& s : records) flat.insert(s.xh, s); }),
+            timeMs([&] { for (const Student& s : records) node.emplace(s.xh, s); }));
+        report("查找（命中）",
+            timeMs([&] { for (const auto& k : hits) sumFlat += flat.find(k)->nl; }),
+            timeMs([&] { for (const auto& k : hits) sumNode += node.find(k)->second.nl; }));
+        report("查找（未命中）",
+            timeMs([&] { for (const auto& k : misses) sumFlat += flat.contains(k); }),
+            timeMs([&] { for (const auto& k : misses) sumNode += node.count(k); }));
+        report("遍历",
+            timeMs([&] { for (const auto& kv : flat) sumFlat += kv.second.nl; }),
+            timeMs([&] { for (const auto& kv : node) sumNode += kv.second.nl; }));
+        report("删除",
+            timeMs([&] { for (const auto& k : hits) sumFlat += flat.erase(k); }),
+            timeMs([&] { for (const auto& k : hits) sumNode += node.erase(k); }));
+        checksum(sumFlat, sumNode);
+    }
+
+    // ========== 文本协议查找：从请求缓冲区切出键直接查找，与先构造 std::string 的旧做法对比 ==========
+    // 请求每行一条："XH 学号" 或 "XM 姓名"；一半学号命中、四分之一学号未命中、四分之一按姓名
+    static void textLookups(size_t n) {
+        std::vector<Student> records = makeStudents(n);
+        ScratchManager scratch(records);
+        const StudentManager& mgr = *scratch.mgr;
+
+        std::mt19937 rng(11);
+        std::string requests;
+        for (size_t i = 0; i < n; ++i) {
+            const Student& s = records[rng() % records.size()];
+            switch (i % 4) {
+            case 0: case 1: requests += "XH " + s.xh + "\n"; break;
+            case 2: requests += "XH 2099" + s.xh.substr(4) + "\n"; break;
+            default: requests += "XM " + s.xm + "\n"; break;
+            }
+        }
+
+        size_t sumNew = 0, sumOld = 0;
+        auto lookup = [&](std::string_view cmd, std::string_view key, size_t& sum) {
+            if (cmd == "XH") {
+                if (const Student* s = mgr.findByXh(key)) sum += s->nl;
+            }
+            else {
+                // 只取同名链的第一条：衡量的是查找本身，而不是同名记录的多少
+                auto range = mgr.findByName(key);
+                if (range.begin() != range.end()) sum += range.begin()->nl;
+            }
+        };
+
+        header("文本协议查找（" + std::to_string(n) + " 条请求）", "string_view", "std::string");
+        report("解析 + 查找",
+            timeMs([&] {
+                std::string_view rest = requests;
+                while (!rest.empty()) {
+                    size_t eol = rest.find('\n');
+                    std::string_view line = rest.substr(0, eol);
+                    rest.remove_prefix(eol == std::string_view::npos ? rest.size() : eol + 1);
+                    lookup(line.substr(0, 2), line.substr(3), sumNew);
+                }
+            }),
+            timeMs([&] {
+                std::istringstream in(requests);
+                std::string line;
+                while (std::getline(in, line)) {
+                    std::string cmd = line.substr(0, 2);
+                    std::string key = line.substr(3);
+                    lookup(cmd, key, sumOld);
+                }
+            }));
+        checksum(sumNew, sumOld);
+    }
+
+    // ========== 查询 DSL：where(...) 与等价的手写循环对比，两列应持平 ==========
+    static void queryDsl(size_t n) {
+        using namespace dsl;
+        std::vector<Student> records = makeStudents(n);
+        ScratchManager scratch(records);
+        const StudentManager& mgr = *scratch.mgr;
+
+        const std::string major = "软件工程";
+        const std::string prefix = "2021";
+        auto query = where(nl >= 18 && zy == major && !xh.startsWith(prefix));
+        size_t sumDsl = 0, sumHand = 0;
+
+        // 两边差距很小，交替各跑多轮取最快一轮，减少顺序与抖动的影响
+        header("查询 DSL（每轮最快）", "where(...)", "手写循环");
+        // 逐行判断：组合出的表达式对象与手写条件
+        reportBest("逐行判断", 20,
+            [&] { for (const Student& s : records) sumDsl += query(s); },
+            [&] {
+                for (const Student& s : records) {
+                    sumHand += s.nl >= 18 && s.zy == major && s.xh.compare(0, prefix.size(), prefix) != 0;
+                }
+            });
+        // 经索引计数：DSL 自动拆出可走索引的部分；手写时自己填 StudentQuery 并判断其余条件
+        StudentQuery q;
+        q.nlMin = 18;
+        q.zy = major;
+        reportBest("经索引计数", 20,
+            [&] { sumDsl += query.count(mgr); },
+            [&] {
+                QueryPlan plan;
+                mgr.forEachMatch(q, plan, [&](const Student& s) {
+                    if (s.xh.compare(0, prefix.size(), prefix) != 0) ++sumHand;
+                });
+            });
+        checksum(sumDsl, sumHand);
+    }
+
+    // ========== 学年升级：整批 rollover 与逐条经 findByXh 取出修改（同一事务提交）对比 ==========
+    // 分不归档、按年级与年龄归档两种规则，每种规则两边各用一个新加载的实例
+    static void rollover(size_t n) {
+        std::vector<Student> records = makeStudents(n);
+        StudentManager::RolloverRules ageOnly;
+        StudentManager::RolloverRules withArchive;
+        withArchive.archiveXhBefore = "2022";
+        withArchive.archiveAgeAbove = 25;
+        size_t sumNew = 0, sumOld = 0;
+
+        header("学年升级（" + std::to_string(n) + " 条记录）", "rollover", "逐条修改");
+        for (const StudentManager::RolloverRules* rules : { &ageOnly, &withArchive }) {
+            double newMs = 0, oldMs = 0;
+            {
+                ScratchManager scratch(records);
+                StudentManager::RolloverResult result;
+                std::string errMsg;
+                newMs = timeMs([&] { scratch.mgr->rollover(*rules, result, errMsg); });
+                sumNew += summaryOf(*scratch.mgr);
+            }
+            {
+                ScratchManager scratch(records);
+                oldMs = timeMs([&] { rolloverByRecord(*scratch.mgr, records, *rules, scratch.archivePath()); });
+                sumOld += summaryOf(*scratch.mgr);
+            }
+            report(rules->archiveXhBefore.empty() ? "全体年龄 +1" : "年龄 +1，归档 2021 级及以前与超过 25 岁", newMs, oldMs);
+        }
+        checksum(sumNew, sumOld);
+    }
+
+    // ========== 年龄内核：AVX2 与标量实现在同一年龄列上对比，两边结果须一致 ==========
+    // 年龄列约 1% 为空行（0）；掩码取约五分之一的行，相当于按某个专业的位图过滤
+    static void ageKernels(size_t n) {
+        std::mt19937 rng(23);
+        std::vector<uint8_t> ages(n);
+        for (auto& a : ages) a = rng() % 100 == 0 ? 0 : static_cast<uint8_t>(17 + rng() % 9);
+        std::vector<uint64_t> mask((n + 63) / 64, 0);
+        for (size_t i = 0; i < n; ++i) {
+            if (rng() % 5 == 0) mask[i >> 6] |= uint64_t(1) << (i & 63);
+        }
+        std::vector<uint8_t> shiftedSimd = ages, shiftedScalar = ages;
+        size_t sumSimd = 0, sumScalar = 0;
+        auto fold = [](size_t& sum, const AgeStats& st) {
+            sum += st.count + static_cast<size_t>(st.sum) + static_cast<size_t>(st.min) + static_cast<size_t>(st.max);
+        };
+
+        header("年龄内核（" + std::to_string(n) + " 行，每轮最快）", "AVX2", "标量");
+        if (!AgeKernels::hasAvx2()) std::cout << "  本机不支持 AVX2，两列均为标量实现\n";
+        reportBest("整列统计", 10,
+            [&] { fold(sumSimd, AgeKernels::aggregate(ages.data(), n, 1, 150)); },
+            [&] { fold(sumScalar, AgeKernels::aggregateMaskedScalar(ages.data(), n, nullptr, 0, 1, 150)); });
+        reportBest("区间 [18, 22] 统计", 10,
+            [&] { fold(sumSimd, AgeKernels::aggregate(ages.data(), n, 18, 22)); },
+            [&] { fold(sumScalar, AgeKernels::aggregateMaskedScalar(ages.data(), n, nullptr, 0, 18, 22)); });
+        reportBest("位图过滤后统计", 10,
+            [&] { fold(sumSimd, AgeKernels::aggregateMasked(ages.data(), n, mask.data(), mask.size(), 1, 150)); },
+            [&] { fold(sumScalar, AgeKernels::aggregateMaskedScalar(ages.data(), n, mask.data(), mask.size(), 1, 150)); });
+        // 每轮两边各加一岁，结束时两份年龄列应逐字节相同
+        reportBest("整列 +1", 10,
+            [&] { AgeKernels::shift(shiftedSimd.data(), n, 1); },
+            [&] { AgeKernels::shiftScalar(shiftedScalar.data(), n, 1); });
+        sumSimd += shiftedSimd == shiftedScalar;
+        sumScalar += 1;
+        checksum(sumSimd, sumScalar);
+    }
+
+private:
+    // 升级前的做法：逐条取出记录、年龄加一后整条替换，应归档的删除，提交后自行写归档文件
+    static void rolloverByRecord(StudentManager& mgr, const std::vector<Student>& records,
+                                 const StudentManager::RolloverRules& rules, const std::string& archivePath) {
+        auto txn = mgr.beginTransaction();
+        std::vector<Student> archived;
+        for (const Student& r : records) {
+            const Student* cur = mgr.findByXh(r.xh);
+            if (!cur) continue;
+            Student s = *cur;
+            s.nl += rules.ageDelta;
+            bool archive = (!rules.archiveXhBefore.empty() && s.xh < rules.archiveXhBefore)
+                || (rules.archiveAgeAbove > 0 && s.nl > rules.archiveAgeAbove);
+            if (archive) {
+                archived.push_back(*cur);
+                txn.remove(s.xh);
+            }
+            else {
+                txn.update(s);
+            }
+        }
+        std::string errMsg;
+        if (txn.commit(errMsg) && !archived.empty()) JsonHelper::appendArchive(archivePath, "bench", archived);
+    }
+
+    // 升级后的人数与年龄总和，两边结果一致时相同
+    static size_t summaryOf(const StudentManager& mgr) {
+        return mgr.count() + static_cast<size_t>(mgr.ageStats().sum);
+    }
+
+    // 基准用的临时实例：数据文件写在临时目录，结束时连同日志、归档文件一起删除
+    struct ScratchManager {
+        std::string path;
+        std::unique_ptr<StudentManager> mgr;
+
+        explicit ScratchManager(const std::vector<Student>& records)
+            : path((std::filesystem::temp_directory_path() / "StudentsInfoBench.json").string()) {
+            removeFiles();
+            JsonHelper::save(path, records);
+            mgr.reset(new StudentManager(path));
+        }
+
+        ~ScratchManager() {
+            mgr.reset();
+            removeFiles();
+        }
+
+        std::string archivePath() const { return JsonHelper::archivePathFor(path); }
+
+        void removeFiles() {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            std::filesystem::remove(JsonHelper::logPathFor(path), ec);
+            std::filesystem::remove(archivePath(), ec);
+        }
+    };
+
+    // 可复现的测试数据：学号唯一，姓名 / 专业从小词表中取，年龄 17-25
+    static std::vector<Student> makeStudents(size_t n) {
+        static const char* surnames[] = { "张", "李", "王", "刘", "陈", "杨", "赵", "黄" };
+        static const char* givens[] = { "伟", "芳", "娜", "敏", "静", "强", "磊", "洋", "艳", "杰" };
+        static const char* majors[] = { "软件工程", "人工智能", "数据科学", "网络工程", "信息安全" };
+        std::mt19937 rng(42);
+        std::vector<Student> records;
+        records.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            char xh[16];
+            snprintf(xh, sizeof(xh), "%04u%08u", 2020u + static_cast<unsigned>(i % 4), static_cast<unsigned>(i));
+            Student s;
+            s.xh = xh;
+            s.xm = std::string(surnames[rng() % 8]) + givens[rng() % 10] + givens[rng() % 10];
+            s.xb = rng() % 2 ? "男" : "女";
+            s.nl = 17 + static_cast<int>(rng() % 9);
+            s.zy = majors[rng() % 5];
+            records.push_back(s);
+        }
+        return records;
+    }
+
+    template <typename Fn>
+    static double timeMs(Fn fn) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template <typename NewFn, typename OldFn>
+    static void reportBest(const std::string& label, int rounds, NewFn newFn, OldFn oldFn) {
+        double bestNew = 0, bestOld = 0;
+        for (int r = 0; r < rounds; ++r) {
+            double n = timeMs(newFn), o = timeMs(oldFn);
+            bestNew = r == 0 ? n : std::min(bestNew, n);
+            bestOld = r == 0 ? o : std::min(bestOld, o);
+        }
+        report(label, bestNew, bestOld);
+    }
+
+    static void header(const std::string& title, const std::string& newName, const std::string& oldName) {
+        std::cout << "\n[" << title << "]\n" << std::setw(19) << newName << std::setw(19) << oldName << "\n";
+    }
+
+    // 中文标签的显示宽度与字节数不同，放在行尾以免打乱数字列的对齐
+    static void report(const std::string& label, double newMs, double oldMs) {
+        std::cout << std::fixed << std::setprecision(2)
+            << std::setw(16) << newMs << " ms" << std::setw(16) << oldMs << " ms"
+            << std::setw(8) << std::setprecision(1) << (newMs > 0 ? oldMs / newMs : 0) << "x   " << label << "\n";
+    }
+
+    static void checksum(size_t a, size_t b) {
+        std::cout << "  校验和 " << a << (a == b ? " 一致" : " 不一致: " + std::to_string(b)) << "\n";
+    }
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// 分块布隆过滤器：每个键的全部 K 位都落在同一个 512 位（一个缓存行）的块内，一次查询只访问一个缓存行
+// 只能加入不能删除：删除的键仍留在过滤器里（只会增加误判，不会漏判），由调用方在删除较多时重建
+class BloomFilter {
+public:
+    static constexpr size_t BITS_PER_KEY = 10;
+    static constexpr unsigned K = 7;
+
+    // 按预计键数重新分配并清空
+    void reset(size_t expectedKeys) {
+        size_t bits = std::max<size_t>(expectedKeys, 64) * BITS_PER_KEY;
+        blocks.assign((bits + BLOCK_BITS - 1) / BLOCK_BITS, Block());
+        planned = std::max<size_t>(expectedKeys, 64);
+        inserted = 0;
+    }
+
+    void add(std::string_view key) {
+        forEachBit(key, [&](size_t block, unsigned word, uint64_t bit) {
+            blocks[block].words[word] |= bit;
+            return true;
+        });
+        ++inserted;
+    }
+
+    // false 表示一定不存在；true 表示可能存在
+    bool mayContain(std::string_view key) const {
+        if (blocks.empty()) return true;
+        return forEachBit(key, [&](size_t block, unsigned word, uint64_t bit) {
+            return (blocks[block].words[word] & bit) != 0;
+        });
+    }
+
+    size_t insertedCount() const { return inserted; }  // 含已删除的键
+    size_t plannedKeys() const { return planned; }
+    size_t bitCount() const { return blocks.size() * BLOCK_BITS; }
+
+    // 理论误判率 (1 - e^(-K·n/m))^K，n 为已加入的键数（含已删除的）
+    double estimatedFpr() const {
+        if (blocks.empty() || inserted == 0) return 0.0;
+        double fill = 1.0 - std::exp(-static_cast<double>(K) * inserted / bitCount());
+        return std::pow(fill, K);
+    }
+
+private:
+    static constexpr uint32_t BLOCK_BITS = 512;
+
+    struct alignas(64) Block {
+        uint64_t words[BLOCK_BITS / 64] = {};
+    };
+
+    std::vector<Block> blocks;
+    size_t planned = 0;
+    size_t inserted = 0;
+
+    // 依次以 (块号, 块内字号, 位掩码) 回调键的 K 个位；回调返回 false 时提前结束并返回 false
+    // add 与 mayContain 共用，保证两边取的是同一组位
+    template <typename Fn>
+    bool forEachBit(std::string_view key, Fn fn) const {
+        uint64_t h = hashKey(key);
+        size_t block = blockOf(h);
+        uint64_t g = h * 0x9E3779B97F4A7C15ULL;  // 块内位置另取一组位，与块号无关
+        uint32_t h1 = static_cast<uint32_t>(g), h2 = static_cast<uint32_t>(g >> 32) | 1;
+        for (unsigned i = 0; i < K; ++i) {
+            uint32_t bit = (h1 + i * h2) & (BLOCK_BITS - 1);
+            if (!fn(block, bit >> 6, uint64_t(1) << (bit & 63))) return false;
+        }
+        return true;
+    }
+
+    static uint64_t hashKey(std::string_view key) {
+        uint64_t h = 14695981039346656037ULL;  // FNV-1a，再做一次 splitmix64 混合
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    size_t blockOf(uint64_t h) const {
+        // 高 32 位乘法映射到 [0, 块数)，避免取模
+        return static_cast<size_t>(((h >> 32) * static_cast<uint64_t>(blocks.size())) >> 32);
+    }
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "Student.h"
+#include "RowBitmap.h"
+
+// 学号分段定义：从第 offset 位起取 length 位，如 年级(0,4) 学院(4,2) 班级(6,2)
+struct IdSegment {
+    std::string name;
+    size_t offset = 0;
+    size_t length = 0;
+};
+
+// 一个分组（如 2023-05-02 班）的成员与统计
+struct Cohort {
+    RowBitmap members;                        // 行号位图
+    uint64_t nlSum = 0;
+    std::map<int, size_t> byNl;               // 年龄 → 人数
+    std::map<std::string, size_t> byZy;       // 专业 → 人数
+
+    size_t count() const { return members.count(); }
+    double averageAge() const { return count() ? static_cast<double>(nlSum) / count() : 0.0; }
+};
+
+// 按学号分段分组的索引：学号只在录入时解析一次，之后按分组键直接取
+class CohortIndex {
+public:
+    CohortIndex() : segments(defaultSegments()) {}
+
+    static std::vector<IdSegment> defaultSegments() {
+        return { { "年级", 0, 4 }, { "学院", 4, 2 }, { "班级", 6, 2 } };
+    }
+
+    const std::vector<IdSegment>& getSegments() const { return segments; }
+
+    // 更换分段定义后需由调用方重新 add 全部记录
+    void setSegments(const std::vector<IdSegment>& segs) {
+        segments = segs;
+        cohorts.clear();
+    }
+
+    void clear() { cohorts.clear(); }
+
+    // 分组键：各段取值以 '-' 连接，如 "2023-05-02"
+    std::string keyOf(const std::string& xh) const {
+        std::string key;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            if (i) key += '-';
+            if (segments[i].offset < xh.size()) key += xh.substr(segments[i].offset, segments[i].length);
+        }
+        return key;
+    }
+
+    void add(uint32_t row, const Student& stu) {
+        Cohort& c = cohorts[keyOf(stu.xh)];
+        c.members.set(row);
+        c.nlSum += stu.nl;
+        ++c.byNl[stu.nl];
+        ++c.byZy[stu.zy];
+    }
+
+    void remove(uint32_t row, const Student& stu) {
+        auto it = cohorts.find(keyOf(stu.xh));
+        if (it == cohorts.end()) return;
+        Cohort& c = it->second;
+        c.members.reset(row);
+        c.nlSum -= stu.nl;
+        if (--c.byNl[stu.nl] == 0) c.byNl.erase(stu.nl);
+        if (--c.byZy[stu.zy] == 0) c.byZy.erase(stu.zy);
+        if (c.members.empty()) cohorts.erase(it);
+    }
+
+    // 原地修改：学号不变则分组不变，只调整年龄 / 专业分布中变化的部分
+    void update(const Student& before, const Student& after) {
+        if (before.nl == after.nl && before.zy == after.zy) return;
+        auto it = cohorts.find(keyOf(after.xh));
+        if (it == cohorts.end()) return;
+        Cohort& c = it->second;
+        if (before.nl != after.nl) {
+            c.nlSum -= before.nl;
+            c.nlSum += after.nl;
+            if (--c.byNl[before.nl] == 0) c.byNl.erase(before.nl);
+            ++c.byNl[after.nl];
+        }
+        if (before.zy != after.zy) {
+            if (--c.byZy[before.zy] == 0) c.byZy.erase(before.zy);
+            ++c.byZy[after.zy];
+        }
+    }
+
+    // 全体成员年龄加 delta（学年升级）：分组成员不变，只平移年龄分布
+    void shiftAges(int delta) {
+        for (auto& kv : cohorts) {
+            Cohort& c = kv.second;
+            c.nlSum += static_cast<int64_t>(delta) * static_cast<int64_t>(c.count());
+            std::map<int, size_t> shifted;
+            for (const auto& age : c.byNl) shifted.emplace_hint(shifted.end(), age.first + delta, age.second);
+            c.byNl.swap(shifted);
+        }
+    }
+
+    const Cohort* find(const std::string& key) const {
+        auto it = cohorts.find(key);
+        return it == cohorts.end() ? nullptr : &it->second;
+    }
+
+    // 键以 prefix 开头的全部分组（如 "2023" 或 "2023-05"），按键有序
+    template <typename Fn>
+    void forEachWithPrefix(const std::string& prefix, Fn fn) const {
+        for (auto it = cohorts.lower_bound(prefix); it != cohorts.end(); ++it) {
+            if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+            fn(it->first, it->second);
+        }
+    }
+
+private:
+    std::vector<IdSegment> segments;
+    std::map<std::string, Cohort> cohorts;  // 分组键 → 分组
+};
@@ -0,0 +1,233 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "StringHash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLATHASHMAP_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 开放寻址哈希表（Swiss table 式）：
+//   - 控制字节数组按 16 个一组探测，每个字节存哈希低 7 位作为指纹，一条 SSE2 比较即可筛出整组候选
+//   - 槽位只存元素下标，键值对本身连续存放在 entries 中，遍历即顺序读数组
+//   - 删除时把最后一个元素搬到空位，entries 始终紧凑；槽位留下墓碑，累积过多时原地重建
+// 支持异构查找：Hash / Eq 为透明函数对象时，find / erase 可直接传 std::string_view
+template <typename K, typename V, typename Hash = StringHash, typename Eq = std::equal_to<>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<K, V>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    FlatHashMap() = default;
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    void clear() {
+        entries.clear();
+        hashes.clear();
+        ctrl.assign(ctrl.size(), EMPTY);
+        tombstones = 0;
+    }
+
+    void reserve(size_t n) {
+        entries.reserve(n);
+        hashes.reserve(n);
+        if (n > maxLoad(capacity())) rehash(capacityFor(n));
+    }
+
+    template <typename Q>
+    V* find(const Q& key) {
+        size_t slot = findSlot(key, hasher(key));
+        return slot == NPOS ? nullptr : &entries[slots[slot]].second;
+    }
+
+    template <typename Q>
+    const V* find(const Q& key) const {
+        size_t slot = findSlot(key, hasher(key));
+        return slot == NPOS ? nullptr : &entries[slots[slot]].second;
+    }
+
+    template <typename Q>
+    bool contains(const Q& key) const { return find(key) != nullptr; }
+
+    // 键不存在时插入；返回值的引用与是否新插入
+    std::pair<V*, bool> insert(K key, V value) {
+        size_t h = hasher(key);
+        size_t slot = findSlot(key, h);
+        if (slot != NPOS) return { &entries[slots[slot]].second, false };
+        growIfNeeded();
+        place(h, static_cast<uint32_t>(entries.size()));
+        entries.emplace_back(std::move(key), std::move(value));
+        hashes.push_back(h);
+        return { &entries.back().second, true };
+    }
+
+    V& operator[](const K& key) {
+        return *insert(key, V()).first;
+    }
+
+    template <typename Q>
+    bool erase(const Q& key) {
+        size_t slot = findSlot(key, hasher(key));
+        if (slot == NPOS) return false;
+        uint32_t idx = slots[slot];
+        ctrl[slot] = DELETED;
+        ++tombstones;
+
+        // 最后一个元素搬到 idx，并改写指向它的槽位
+        uint32_t last = static_cast<uint32_t>(entries.size() - 1);
+        if (idx != last) {
+            slots[slotOfIndex(last)] = idx;
+            entries[idx] = std::move(entries[last]);
+            hashes[idx] = hashes[last];
+        }
+        entries.pop_back();
+        hashes.pop_back();
+        return true;
+    }
+
+private:
+    static constexpr size_t GROUP = 16;
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+    static constexpr int8_t EMPTY = -128;   // 0x80
+    static constexpr int8_t DELETED = -2;   // 0xFE；有效指纹为 0-127
+
+    std::vector<value_type> entries;   // 连续存放的键值对
+    std::vector<size_t> hashes;        // 与 entries 对应的哈希，搬移与扩容时不必重算
+    std::vector<int8_t> ctrl;          // 槽位控制字节
+    std::vector<uint32_t> slots;       // 槽位 → entries 下标
+    size_t tombstones = 0;
+    Hash hasher;
+    Eq eq;
+
+    size_t capacity() const { return ctrl.size(); }
+    static size_t maxLoad(size_t cap) { return cap - cap / 8; }  // 负载上限 7/8
+
+    static size_t capacityFor(size_t n) {
+        size_t cap = GROUP;
+        while (maxLoad(cap) < n) cap *= 2;
+        return cap;
+    }
+
+    static int8_t fingerprint(size_t h) { return static_cast<int8_t>(h & 0x7F); }
+    size_t firstGroup(size_t h) const { return (h >> 7) & (capacity() / GROUP - 1); }
+
+    // 组内等于 b 的字节位置掩码
+    uint32_t matchByte(size_t group, int8_t b) const {
+        const int8_t* p = ctrl.data() + group * GROUP;
+#ifdef FLATHASHMAP_SSE2
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(b))));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; ++i) {
+            if (p[i] == b) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // 组内空槽或墓碑（最高位为 1）的位置掩码
+    uint32_t matchFree(size_t group) const {
+        const int8_t* p = ctrl.data() + group * GROUP;
+#ifdef FLATHASHMAP_SSE2
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; ++i) {
+            if (p[i] < 0) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    static unsigned lowestBit(uint32_t x) {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanForward(&idx, x);
+        return idx;
+#else
+        return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+    }
+
+    // 按组做三角探测（组数为 2 的幂，可遍历全部组）
+    template <typename Fn>
+    size_t probe(size_t h, Fn fn) const {
+        size_t groups = capacity() / GROUP;
+        size_t g = firstGroup(h);
+        for (size_t i = 0; i < groups; ++i) {
+            size_t r = fn(g);
+            if (r != NPOS - 1) return r;
+            g = (g + i + 1) & (groups - 1);
+        }
+        return NPOS;
+    }
+
+    template <typename Q>
+    size_t findSlot(const Q& key, size_t h) const {
+        if (ctrl.empty()) return NPOS;
+        int8_t fp = fingerprint(h);
+        return probe(h, [&](size_t g) {
+            for (uint32_t m = matchByte(g, fp); m; m &= m - 1) {
+                size_t slot = g * GROUP + lowestBit(m);
+                uint32_t idx = slots[slot];
+                if (hashes[idx] == h && eq(entries[idx].first, key)) return slot;
+            }
+            // 组内有空槽说明键不可能在更后面的组
+            return matchByte(g, EMPTY) ? NPOS : NPOS - 1;
+        });
+    }
+
+    // entries 下标 → 槽位（用于删除时改写被搬移元素的槽位）
+    size_t slotOfIndex(uint32_t idx) const {
+        size_t h = hashes[idx];
+        int8_t fp = fingerprint(h);
+        return probe(h, [&](size_t g) {
+            for (uint32_t m = matchByte(g, fp); m; m &= m - 1) {
+                size_t slot = g * GROUP + lowestBit(m);
+                if (slots[slot] == idx) return slot;
+            }
+            return NPOS - 1;
+        });
+    }
+
+    void place(size_t h, uint32_t idx) {
+        size_t slot = probe(h, [&](size_t g) {
+            uint32_t m = matchFree(g);
+            return m ? g * GROUP + lowestBit(m) : NPOS - 1;
+        });
+        if (ctrl[slot] == DELETED) --tombstones;
+        ctrl[slot] = fingerprint(h);
+        slots[slot] = idx;
+    }
+
+    void growIfNeeded() {
+        if (entries.size() + tombstones + 1 <= maxLoad(capacity())) return;
+        // 墓碑占多数时同容量重建即可，否则翻倍
+        rehash(entries.size() + 1 > maxLoad(capacity()) / 2 ? capacityFor(entries.size() + 1) * 2
+                                                            : capacity());
+    }
+
+    void rehash(size_t cap) {
+        ctrl.assign(cap, EMPTY);
+        slots.assign(cap, 0);
+        tombstones = 0;
+        for (size_t i = 0; i < entries.size(); ++i) place(hashes[i], static_cast<uint32_t>(i));
+    }
+};
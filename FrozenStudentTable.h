@@ -0,0 +1,232 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include "Student.h"
+#include "MinimalPerfectHash.h"
+
+// 冻结后的只读学生表：记录紧凑存放，学号与姓名查找都走最小完美哈希
+//   - 字符串统一放在一个字符池里，姓名、性别、专业去重后只存一份，每行只存池下标（16 字节/行）
+//   - 性别取值很少，另设一张取值表，行内只存 16 位的表下标（池下标会随学号数量超过 16 位）
+//   - 行按学号有序；学号哈希槽 → 行号，姓名哈希槽 → 该姓名的行号区间
+//   - 学号槽内直接存 12 位学号本身，查找只访问位移表与槽两处内存，不必再去字符池核对
+// 构建后不可修改
+class FrozenStudentTable {
+public:
+    // 一行的只读视图（字符串指向表内字符池，表存在期间有效）
+    struct Row {
+        std::string_view xh;
+        std::string_view xm;
+        std::string_view xb;
+        int nl = 0;
+        std::string_view zy;
+
+        Student toStudent() const {
+            return { std::string(xh), std::string(xm), std::string(xb), nl, std::string(zy) };
+        }
+    };
+
+    // records 须按学号有序且学号互不相同；性别取值超过 65535 种、年龄超出 16 位范围或记录超过 2^31 条时失败
+    static bool build(const std::vector<Student>& records, FrozenStudentTable& out, std::string& errMsg) {
+        if (records.size() >= XH_IN_POOL) {
+            errMsg = "记录过多，无法冻结";
+            return false;
+        }
+        FrozenStudentTable t;
+        std::unordered_map<std::string, uint32_t> interned;
+        std::unordered_map<std::string, uint16_t> xbIds;
+        auto intern = [&](const std::string& s) {
+            auto it = interned.find(s);
+            if (it != interned.end()) return it->second;
+            uint32_t id = t.addString(s);
+            interned.emplace(s, id);
+            return id;
+        };
+
+        t.rows.reserve(records.size());
+        for (const auto& s : records) {
+            if (s.nl < std::numeric_limits<int16_t>::min() || s.nl > std::numeric_limits<int16_t>::max()) {
+                errMsg = "学号 " + s.xh + " 的年龄超出冻结表可存储的范围";
+                return false;
+            }
+            auto xb = xbIds.find(s.xb);
+            if (xb == xbIds.end()) {
+                if (t.xbValues.size() > std::numeric_limits<uint16_t>::max()) {
+                    errMsg = "性别取值过多，无法冻结";
+                    return false;
+                }
+                xb = xbIds.emplace(s.xb, static_cast<uint16_t>(t.xbValues.size())).first;
+                t.xbValues.push_back(intern(s.xb));
+            }
+
+            PackedRow r;
+            r.xh = t.addString(s.xh);  // 学号唯一，不必去重
+            r.xm = intern(s.xm);
+            r.zy = intern(s.zy);
+            r.xb = xb->second;
+            r.nl = static_cast<int16_t>(s.nl);
+            t.rows.push_back(r);
+        }
+        t.strOffsets.push_back(static_cast<uint32_t>(t.chars.size()));  // 末尾哨兵
+
+        // 学号：槽 → 行号
+        std::vector<std::string_view> keys;
+        keys.reserve(t.rows.size());
+        for (const auto& r : t.rows) keys.push_back(t.str(r.xh));
+        t.xhHash.build(keys);
+        t.xhSlots.assign(t.rows.size(), XhSlot());
+        for (size_t i = 0; i < t.rows.size(); ++i) {
+            XhSlot& slot = t.xhSlots[t.xhHash.slotOf(keys[i])];
+            slot.row = static_cast<uint32_t>(i);
+            if (keys[i].size() == XH_INLINE) std::memcpy(slot.key, keys[i].data(), XH_INLINE);
+            else slot.row |= XH_IN_POOL;
+        }
+
+        // 姓名：同名行号连续存放，槽 → (姓名, 起点, 人数)
+        std::unordered_map<uint32_t, std::vector<uint32_t>> byName;
+        std::vector<uint32_t> nameIds;
+        for (size_t i = 0; i < t.rows.size(); ++i) {
+            auto& list = byName[t.rows[i].xm];
+            if (list.empty()) nameIds.push_back(t.rows[i].xm);
+            list.push_back(static_cast<uint32_t>(i));
+        }
+        keys.clear();
+        for (uint32_t id : nameIds) keys.push_back(t.str(id));
+        t.nameHash.build(keys);
+        t.nameGroups.assign(nameIds.size(), NameGroup());
+        t.nameRows.reserve(t.rows.size());
+        for (size_t i = 0; i < nameIds.size(); ++i) {
+            const auto& list = byName[nameIds[i]];
+            NameGroup& g = t.nameGroups[t.nameHash.slotOf(keys[i])];
+            g.name = nameIds[i];
+            g.begin = static_cast<uint32_t>(t.nameRows.size());
+            g.count = static_cast<uint32_t>(list.size());
+            t.nameRows.insert(t.nameRows.end(), list.begin(), list.end());
+        }
+        out = std::move(t);
+        return true;
+    }
+
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    size_t size() const { return rows.size(); }
+    bool empty() const { return rows.empty(); }
+
+    // 第 i 行（按学号顺序）
+    Row at(size_t i) const {
+        const PackedRow& r = rows[i];
+        return { str(r.xh), str(r.xm), str(xbValues[r.xb]), r.nl, str(r.zy) };
+    }
+
+    // 学号所在的行号（按学号顺序），不存在时为 NPOS
+    size_t indexOf(std::string_view xh) const {
+        if (rows.empty()) return NPOS;
+        const XhSlot& slot = xhSlots[xhHash.slotOf(xh)];
+        // 不在表中的键也会落到某个槽，须核对
+        if (!(slot.row & XH_IN_POOL)) {
+            return xh.size() == XH_INLINE && std::memcmp(slot.key, xh.data(), XH_INLINE) == 0 ? slot.row : NPOS;
+        }
+        uint32_t i = slot.row & ~XH_IN_POOL;
+        return str(rows[i].xh) == xh ? i : NPOS;
+    }
+
+    bool findByXh(std::string_view xh, Row& out) const {
+        size_t i = indexOf(xh);
+        if (i == NPOS) return false;
+        out = at(i);
+        return true;
+    }
+
+    size_t countByName(std::string_view xm) const {
+        const NameGroup* g = groupOf(xm);
+        return g ? g->count : 0;
+    }
+
+    // 同名各行的行号（按学号顺序连续存放）：起点与人数，不存在时人数为 0
+    std::pair<const uint32_t*, size_t> rowsOfName(std::string_view xm) const {
+        const NameGroup* g = groupOf(xm);
+        return g ? std::make_pair(nameRows.data() + g->begin, static_cast<size_t>(g->count))
+                 : std::make_pair(static_cast<const uint32_t*>(nullptr), size_t(0));
+    }
+
+    std::vector<Row> findByName(std::string_view xm) const {
+        std::vector<Row> result;
+        if (const NameGroup* g = groupOf(xm)) {
+            result.reserve(g->count);
+            for (uint32_t k = 0; k < g->count; ++k) result.push_back(at(nameRows[g->begin + k]));
+        }
+        return result;
+    }
+
+    // 按学号顺序遍历
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < rows.size(); ++i) fn(at(i));
+    }
+
+    // 表占用的字节数（不含对象本身）
+    size_t memoryBytes() const {
+        return chars.capacity() + strOffsets.capacity() * sizeof(uint32_t)
+            + rows.capacity() * sizeof(PackedRow) + xbValues.capacity() * sizeof(uint32_t)
+            + xhSlots.capacity() * sizeof(XhSlot) + xhHash.memoryBytes()
+            + nameGroups.capacity() * sizeof(NameGroup) + nameRows.capacity() * sizeof(uint32_t)
+            + nameHash.memoryBytes();
+    }
+
+private:
+    struct PackedRow {
+        uint32_t xh;   // 字符池下标
+        uint32_t xm;
+        uint32_t zy;
+        uint16_t xb;   // 性别取值表下标
+        int16_t nl;
+    };
+
+    // 学号槽：Validator 要求的 12 位学号直接存在槽内；其他长度的学号（旧数据）在行号上置最高位，回字符池核对
+    static constexpr size_t XH_INLINE = 12;
+    static constexpr uint32_t XH_IN_POOL = 1u << 31;
+    struct XhSlot {
+        char key[XH_INLINE] = {};
+        uint32_t row = 0;
+    };
+
+    struct NameGroup {
+        uint32_t name = 0;   // 字符池下标
+        uint32_t begin = 0;  // nameRows 中的起点
+        uint32_t count = 0;
+    };
+
+    std::string chars;                  // 字符池
+    std::vector<uint32_t> strOffsets;   // 字符串 id → 在池中的起点（末尾多一个哨兵）
+    std::vector<PackedRow> rows;        // 按学号有序
+    std::vector<uint32_t> xbValues;     // 性别取值表：表下标 → 字符池下标
+
+    MinimalPerfectHash xhHash;
+    std::vector<XhSlot> xhSlots;        // 学号槽 → (学号, 行号)，16 字节/槽
+
+    MinimalPerfectHash nameHash;
+    std::vector<NameGroup> nameGroups;  // 姓名槽 → 同名行区间
+    std::vector<uint32_t> nameRows;     // 同名行号连续存放
+
+    uint32_t addString(const std::string& s) {
+        strOffsets.push_back(static_cast<uint32_t>(chars.size()));
+        chars += s;
+        return static_cast<uint32_t>(strOffsets.size() - 1);
+    }
+
+    std::string_view str(uint32_t id) const {
+        return std::string_view(chars.data() + strOffsets[id], strOffsets[id + 1] - strOffsets[id]);
+    }
+
+    const NameGroup* groupOf(std::string_view xm) const {
+        if (nameGroups.empty()) return nullptr;
+        const NameGroup& g = nameGroups[nameHash.slotOf(xm)];
+        return str(g.name) == xm ? &g : nullptr;
+    }
+};
@@ -2,6 +2,9 @@
 #include <string>
 #include <fstream>
 #include <unordered_map>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
 #include "Student.h"
 #include "nlohmann/json.hpp"
 
@@ -24,60 +27,111 @@ private:
 #endif
     }
 
-    // 获取数据文件路径（优先新文件名，兼容旧文件名）
-    static std::string getDataPathForRead() {
-        std::string dir = getExeDir();
-        std::string newPath = dir + "data.json";
-        std::string oldPath = dir + "data. json";  // 旧文件名（有空格）
-        
-        // 优先尝试新文件名
-        std::ifstream testNew(newPath);
+    // 用 from 原子替换 to（同一目录内改名）
+    static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+
+    // 获取读取路径：默认数据文件不存在时兼容旧文件名
+    static std::string getDataPathForRead(const std::string& dataPath) {
+        // 优先尝试指定文件
+        std::ifstream testNew(dataPath);
         if (testNew.good()) {
-            return newPath;
+            return dataPath;
         }
-        // 兼容旧文件名
-        std::ifstream testOld(oldPath);
-        if (testOld.good()) {
-            return oldPath;
+        // 兼容旧文件名（有空格），仅对默认数据文件生效
+        if (dataPath == defaultDataPath()) {
+            std::string oldPath = getExeDir() + "data. json";
+            std::ifstream testOld(oldPath);
+            if (testOld.good()) {
+                return oldPath;
+            }
         }
-        // 都不存在，返回新文件名（用于创建）
-        return newPath;
+        // 都不存在，返回指定文件（用于创建）
+        return dataPath;
     }
 
-    // 保存时统一用新文件名
-    static std::string getDataPathForWrite() {
+public:
+    // 默认数据文件：exe 同目录下的 data.json（保存时统一用新文件名）
+    static std::string defaultDataPath() {
         return getExeDir() + "data.json";
     }
 
-public:
-    // 保存
-    static bool save(const std::unordered_multimap<std::string, Student>& students) {
+    // 变更日志与数据文件同名、扩展名为 .log；每次提交追加一行 JSON，保存快照后清空
+    static std::string logPathFor(const std::string& dataPath) {
+        size_t slash = dataPath.find_last_of("\\/");
+        size_t dot = dataPath.find_last_of('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return dataPath + ".log";
+        }
+        return dataPath.substr(0, dot) + ".log";
+    }
+
+    // 归档文件：与数据文件同名、扩展名为 .archive.json，学年升级时移出的记录追加到这里
+    static std::string archivePathFor(const std::string& dataPath) {
+        std::string log = logPathFor(dataPath);
+        return log.substr(0, log.size() - 4) + ".archive.json";
+    }
+
+    // 追加一批归档记录：归档文件是批次数组 [{"batch": 批次号, "students": [...]}]，读出后整体重写
+    // 同一批次号已存在时不再写入（重试与日志回放可能重复提交同一批）；已有文件损坏时不覆盖
+    static bool appendArchive(const std::string& archivePath, const std::string& batchId,
+                              const std::vector<Student>& records) {
         try {
-            nlohmann::json j = nlohmann::json::array();
-            for (const auto& pair : students) {
-                j.push_back(pair.second);
+            nlohmann::json batches = nlohmann::json::array();
+            {
+                std::ifstream in(archivePath);
+                if (in.is_open()) in >> batches;
             }
-            std::ofstream out(getDataPathForWrite());
+            for (const auto& b : batches) {
+                if (b.value("batch", "") == batchId) return true;
+            }
+            batches.push_back({ { "batch", batchId }, { "students", records } });
+            std::ofstream out(archivePath);
             if (!out.is_open()) return false;
-            out << j.dump(4);
-            return true;
+            out << batches.dump(4);
+            return out.good();
         }
         catch (...) {
             return false;
         }
     }
 
-    // 加载
-    static bool load(std::unordered_multimap<std::string, Student>& students) {
+    // 保存：数据文件为 {"seq": 已包含的最后一条日志序号, "students": [...]}
+    // 先写临时文件再整体替换，崩溃时磁盘上要么是旧文件、要么是完整的新文件
+    static bool save(const std::string& dataPath, const std::vector<Student>& students, uint64_t seq = 0) {
         try {
-            std::string path = getDataPathForRead();
+            nlohmann::json j = { { "seq", seq }, { "students", students } };
+            std::string tmpPath = dataPath + ".tmp";
+            {
+                std::ofstream out(tmpPath, std::ios::trunc);
+                if (!out.is_open()) return false;
+                out << j.dump(4);
+                out.flush();
+                if (!out.good()) return false;
+            }
+            return replaceFile(tmpPath, dataPath);
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
+    // 加载；旧格式（直接是学生数组）的 seq 视为 0
+    static bool load(const std::string& dataPath, std::vector<Student>& students, uint64_t& seq) {
+        try {
+            std::string path = getDataPathForRead(dataPath);
             std::ifstream in(path);
             if (!in.is_open()) return false;
             nlohmann::json j;
             in >> j;
-            for (const auto& item : j) {
-                Student stu = item.get<Student>();
-                students.insert({ stu.xm, stu });
+            seq = j.is_object() ? j.value("seq", uint64_t(0)) : 0;
+            for (const auto& item : j.is_object() ? j.at("students") : j) {
+                students.push_back(item.get<Student>());
             }
             return true;
         }
@@ -85,4 +139,89 @@ public:
             return false;
         }
     }
+
+    // 追加一条变更记录（一次提交只写一行）
+    static bool appendLog(const std::string& logPath, const nlohmann::json& record) {
+        try {
+            std::ofstream out(logPath, std::ios::app);
+            if (!out.is_open()) return false;
+            out << record.dump() << "\n";
+            out.flush();
+            return out.good();
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
+    // 读取全部变更记录（跳过损坏的行，如写到一半时崩溃）
+    static bool loadLog(const std::string& logPath, std::vector<nlohmann::json>& records) {
+        std::ifstream in(logPath);
+        if (!in.is_open()) return false;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            try {
+                records.push_back(nlohmann::json::parse(line));
+            }
+            catch (...) {
+                // 忽略损坏行
+            }
+        }
+        return true;
+    }
+
+    // 清空日志（数据文件保存成功后调用），并写入一行保存标记 {"saved": 保存代号}
+    // 跟随进程看到日志首行变成新的保存标记，即知主进程已保存，与它读到日志的哪个位置无关
+    static bool clearLog(const std::string& logPath, const std::string& saveId) {
+        std::ofstream out(logPath, std::ios::trunc);
+        if (!out.is_open()) return false;
+        out << nlohmann::json({ { "saved", saveId } }).dump() << "\n";
+        out.flush();
+        return out.good();
+    }
+
+    // 日志行是否为保存标记（而非变更记录）
+    static bool isSaveMarker(const std::string& line) {
+        try {
+            nlohmann::json j = nlohmann::json::parse(line);
+            return j.is_object() && j.contains("saved") && !j.contains("ops");
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
+    // 读取日志第一行（跟随进程据此判断主进程是否已清空并重写日志）
+    static std::string readLogHead(const std::string& logPath) {
+        std::ifstream in(logPath);
+        std::string line;
+        if (in.is_open()) std::getline(in, line);
+        return line;
+    }
+
+    // 从 offset 处读取新追加的完整行并前移 offset；未写完的半行留到下次读取
+    static bool readLogTail(const std::string& logPath, std::streamoff& offset, std::vector<std::string>& lines) {
+        std::ifstream in(logPath, std::ios::binary);
+        if (!in.is_open()) return false;
+        in.seekg(0, std::ios::end);
+        std::streamoff size = in.tellg();
+        if (size <= offset) return true;
+
+        std::string chunk(static_cast<size_t>(size - offset), '\0');
+        in.seekg(offset);
+        in.read(&chunk[0], static_cast<std::streamsize>(chunk.size()));
+        chunk.resize(static_cast<size_t>(in.gcount()));
+
+        size_t start = 0;
+        size_t nl;
+        while ((nl = chunk.find('\n', start)) != std::string::npos) {
+            std::string line = chunk.substr(start, nl - start);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) lines.push_back(line);
+            start = nl + 1;
+        }
+        offset += static_cast<std::streamoff>(start);
+        return true;
+    }
 };
\ No newline at end of file
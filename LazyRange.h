@@ -0,0 +1,239 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+#include <variant>
+#include <utility>
+#include <type_traits>
+#include <bitset>
+#include <cstdint>
+#include <cstddef>
+#include "Student.h"
+#include "RowBitmap.h"
+#include "RowStore.h"
+#include "StudentQuery.h"
+
+// 惰性结果区间：按需逐条产出，过滤/投影/取前 N 条/计数都在遍历时完成，不生成中间 vector
+// 每个数据源提供 const value_type* next()，返回 nullptr 表示结束；区间引用管理器内部数据，
+// 与迭代器一样，增删改之后不得继续使用
+
+// ---------- 数据源 ----------
+// 全部有效行（行号顺序）
+class AllRowsSource {
+public:
+    using value_type = Student;
+
+    explicit AllRowsSource(const RowStore& r) : rows(&r) {}
+
+    const Student* next() {
+        while (pos < rows->slotCount()) {
+            size_t id = pos++;
+            if (rows->isLive(id)) return &(*rows)[id];
+        }
+        return nullptr;
+    }
+
+private:
+    const RowStore* rows;
+    size_t pos = 0;
+};
+
+// 位图中置位的行（行号顺序）；位图为空指针表示没有任何行
+class BitmapSource {
+public:
+    using value_type = Student;
+
+    BitmapSource(const RowStore& r, const RowBitmap* b)
+        : rows(&r), bits(b), word(0), pending(b && b->wordCount() ? b->data()[0] : 0) {}
+
+    const Student* next() {
+        if (!bits) return nullptr;
+        while (!pending) {
+            if (++word >= bits->wordCount()) return nullptr;
+            pending = bits->data()[word];
+        }
+        size_t bit = std::bitset<64>((pending & (~pending + 1)) - 1).count();  // 最低置位的位置
+        pending &= pending - 1;
+        return &(*rows)[word * 64 + bit];
+    }
+
+private:
+    const RowStore* rows;
+    const RowBitmap* bits;
+    size_t word;
+    uint64_t pending;  // 当前字中尚未产出的置位
+};
+
+// 学号有序索引上的一段（学号顺序）：从 from 起，到超出 to 或不再以 prefix 开头为止
+class XhRangeSource {
+public:
+    using value_type = Student;
+
+    XhRangeSource(const RowStore& r, const std::map<std::string, uint32_t, std::less<>>& order,
+                  const std::string& from, std::optional<std::string> to, std::string prefix)
+        : rows(&r), it(order.lower_bound(from)), end(order.end()), to(std::move(to)), prefix(std::move(prefix)) {}
+
+    const Student* next() {
+        if (it == end) return nullptr;
+        if (to && it->first > *to) return nullptr;
+        if (it->first.compare(0, prefix.size(), prefix) != 0) return nullptr;
+        return &(*rows)[(it++)->second];
+    }
+
+private:
+    const RowStore* rows;
+    std::map<std::string, uint32_t, std::less<>>::const_iterator it, end;
+    std::optional<std::string> to;
+    std::string prefix;
+};
+
+// 组合条件查询：由调用方选定上面三种访问路径之一，再逐条核对全部条件
+class QuerySource {
+public:
+    using value_type = Student;
+
+    template <typename Access>
+    QuerySource(Access a, StudentQuery q) : access(std::move(a)), query(std::move(q)) {}
+
+    const Student* next() {
+        while (const Student* s = std::visit([](auto& a) { return a.next(); }, access)) {
+            if (query.matches(*s)) return s;
+        }
+        return nullptr;
+    }
+
+private:
+    std::variant<AllRowsSource, BitmapSource, XhRangeSource> access;
+    StudentQuery query;
+};
+
+// ---------- 组合 ----------
+template <typename Src, typename Pred>
+class FilterSource {
+public:
+    using value_type = typename Src::value_type;
+
+    FilterSource(Src s, Pred p) : src(std::move(s)), pred(std::move(p)) {}
+
+    const value_type* next() {
+        while (const value_type* v = src.next()) {
+            if (pred(*v)) return v;
+        }
+        return nullptr;
+    }
+
+private:
+    Src src;
+    Pred pred;
+};
+
+template <typename Src>
+class TakeSource {
+public:
+    using value_type = typename Src::value_type;
+
+    TakeSource(Src s, size_t n) : src(std::move(s)), left(n) {}
+
+    const value_type* next() {
+        if (left == 0) return nullptr;
+        --left;
+        return src.next();
+    }
+
+private:
+    Src src;
+    size_t left;
+};
+
+// 投影：当前结果暂存在源内，下一次 next() 时覆盖
+template <typename Src, typename Fn>
+class MapSource {
+public:
+    using value_type = std::decay_t<decltype(std::declval<Fn&>()(std::declval<const typename Src::value_type&>()))>;
+
+    MapSource(Src s, Fn f) : src(std::move(s)), fn(std::move(f)) {}
+
+    const value_type* next() {
+        const typename Src::value_type* v = src.next();
+        if (!v) return nullptr;
+        current.emplace(fn(*v));
+        return &*current;
+    }
+
+private:
+    Src src;
+    Fn fn;
+    std::optional<value_type> current;
+};
+
+template <typename Src>
+class LazyRange {
+public:
+    using value_type = typename Src::value_type;
+
+    explicit LazyRange(Src s) : src(std::move(s)) {}
+
+    // 单遍输入迭代器，供 range-for 使用
+    class iterator {
+    public:
+        iterator() = default;
+        explicit iterator(LazyRange* r) : range(r), cur(r->src.next()) {}
+
+        const value_type& operator*() const { return *cur; }
+        const value_type* operator->() const { return cur; }
+        iterator& operator++() {
+            cur = range->src.next();
+            return *this;
+        }
+        bool operator==(const iterator& o) const { return cur == o.cur; }
+        bool operator!=(const iterator& o) const { return cur != o.cur; }
+
+    private:
+        LazyRange* range = nullptr;
+        const value_type* cur = nullptr;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+    template <typename Pred>
+    LazyRange<FilterSource<Src, Pred>> filter(Pred pred) && {
+        return LazyRange<FilterSource<Src, Pred>>(FilterSource<Src, Pred>(std::move(src), std::move(pred)));
+    }
+
+    LazyRange<TakeSource<Src>> take(size_t n) && {
+        return LazyRange<TakeSource<Src>>(TakeSource<Src>(std::move(src), n));
+    }
+
+    template <typename Fn>
+    LazyRange<MapSource<Src, Fn>> map(Fn fn) && {
+        return LazyRange<MapSource<Src, Fn>>(MapSource<Src, Fn>(std::move(src), std::move(fn)));
+    }
+
+    // 以下为终结操作，会消耗区间
+    size_t count() {
+        size_t n = 0;
+        while (src.next()) ++n;
+        return n;
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) {
+        while (const value_type* v = src.next()) fn(*v);
+    }
+
+    std::optional<value_type> first() {
+        const value_type* v = src.next();
+        return v ? std::optional<value_type>(*v) : std::nullopt;
+    }
+
+    std::vector<value_type> toVector() {
+        std::vector<value_type> out;
+        while (const value_type* v = src.next()) out.push_back(*v);
+        return out;
+    }
+
+private:
+    Src src;
+};
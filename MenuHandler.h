@@ -4,7 +4,9 @@
 #include <vector>
 #include <limits>
 #include <cstdlib>
+#include <iomanip>
 #include "StudentManager.h"
+#include "QueryLanguage.h"
 #include "Validator.h"
 
 // 防止 windows.h 中的 max 宏干扰 std::numeric_limits::max()
@@ -58,10 +60,23 @@ private:
             << "3. 修改学生（按姓名）\n"
             << "4. 查询学生（按专业）\n"
             << "5. 显示全部学生\n"
+            << "6. 统计信息\n"
+            << "7. 查询语句\n"
+            << "8. 学年升级\n"
             << "0. 保存并退出\n"
             << "==============================\n";
     }
 
+    // 姓名不完全匹配时给出包含该片段的姓名
+    static void showNameSuggestions(const StudentManager& mgr, const std::string& name) {
+        auto similar = mgr.searchByNameSubstring(name, 10);
+        if (similar.empty()) return;
+        std::cout << "相近的姓名:\n";
+        for (const auto& s : similar) {
+            std::cout << "  " << s.xm << " (" << s.xh << ")\n";
+        }
+    }
+
     static void showMajors() {
         std::cout << "可选专业: ";
         for (const auto& m : Validator::getValidMajors()) {
@@ -71,8 +86,7 @@ private:
     }
 
     // ========== 1. 录入 ==========
-    static void handleAdd() {
-        auto& mgr = StudentManager::getInstance();
+    static void handleAdd(StudentManager& mgr) {
         std::cout << "\n--- 录入学生 (任意输入项输入 q 可退出) ---\n";
 
         while (true) {
@@ -171,25 +185,23 @@ private:
     }
 
     // ========== 2. 删除（按姓名） ==========
-    static void handleDelete() {
-        auto& mgr = StudentManager::getInstance();
+    static void handleDelete(StudentManager& mgr) {
         std::cout << "\n--- 删除学生 (输入 q 可退出) ---\n";
         
         std::string name = readString("输入要删除的学生姓名: ");
         if (isQuit(name)) return;
 
         auto range = mgr.findByName(name);
-        auto begin = range.first;
-        auto end = range.second;
-        if (begin == end) {
+        if (range.empty()) {
             std::cout << "未找到姓名为「" << name << "」的学生\n";
+            showNameSuggestions(mgr, name);
             return;
         }
 
         // 收集匹配项
-        std::vector<Student*> matches;
-        for (auto it = begin; it != end; ++it) {
-            matches.push_back(&it->second);
+        std::vector<const Student*> matches;
+        for (const Student& s : range) {
+            matches.push_back(&s);
         }
 
         // 显示列表
@@ -220,25 +232,23 @@ private:
     }
 
     // ========== 3. 修改（按姓名） ==========
-    static void handleModify() {
-        auto& mgr = StudentManager::getInstance();
+    static void handleModify(StudentManager& mgr) {
         std::cout << "\n--- 修改学生 (输入 q 可退出) ---\n";
         
         std::string name = readString("输入要修改的学生姓名: ");
         if (isQuit(name)) return;
 
         auto range = mgr.findByName(name);
-        auto begin = range.first;
-        auto end = range.second;
-        if (begin == end) {
+        if (range.empty()) {
             std::cout << "未找到姓名为「" << name << "」的学生\n";
+            showNameSuggestions(mgr, name);
             return;
         }
 
         // 收集匹配项
-        std::vector<Student*> matches;
-        for (auto it = begin; it != end; ++it) {
-            matches.push_back(&it->second);
+        std::vector<const Student*> matches;
+        for (const Student& s : range) {
+            matches.push_back(&s);
         }
 
         // 显示列表
@@ -258,7 +268,8 @@ private:
             return;
         }
 
-        Student* stu = matches[idx - 1];
+        Student updated = *matches[idx - 1];  // 在副本上修改，最后整体提交
+        Student* stu = &updated;
         std::cout << "当前: " << stu->xh << ", " << stu->xm << ", "
             << stu->xb << ", " << stu->nl << ", " << stu->zy << "\n";
         std::cout << "(直接回车保持原值, 输入 q 退出修改)\n";
@@ -307,32 +318,240 @@ private:
             }
         }
 
-        std::cout << "√ 修改完成\n";
+        std::string errMsg;
+        if (mgr.updateStudent(updated, errMsg)) {
+            std::cout << "√ 修改完成\n";
+        } else {
+            std::cout << "× 修改失败: " << errMsg << "\n";
+        }
     }
 
     // ========== 4. 查询（按专业） ==========
-    static void handleSearch() {
-        auto& mgr = StudentManager::getInstance();
+    static void handleSearch(StudentManager& mgr) {
         std::cout << "\n--- 查询学生 (输入 q 可退出) ---\n";
         showMajors();
         
         std::string zy = readString("输入要查询的专业: ");
         if (isQuit(zy)) return;
 
-        auto results = mgr.searchByZy(zy);
-        if (results.empty()) {
+        size_t total = mgr.countOfZy(zy);
+        if (total == 0) {
             std::cout << "未找到该专业的学生\n";
+            return;
+        }
+        std::cout << "找到 " << total << " 人\n";
+        StudentQuery filter;
+        filter.zy = zy;
+        browsePages(mgr, &filter);
+    }
+
+    // ========== 5. 显示全部（分页） ==========
+    static void handleList(const StudentManager& mgr) {
+        if (mgr.count() == 0) {
+            std::cout << "暂无学生数据\n";
+            return;
+        }
+        std::cout << "共 " << mgr.count() << " 人\n";
+        browsePages(mgr, nullptr);
+    }
+
+    static constexpr size_t PAGE_SIZE = 20;
+
+    // 按学号分页浏览：n 下一页，p 上一页，j 学号 跳转，q 返回
+    static void browsePages(const StudentManager& mgr, const StudentQuery* filter) {
+        StudentManager::Page page = mgr.pageFrom("", PAGE_SIZE, filter);
+        while (true) {
+            printTable(page.rows);
+            std::string hint = "[";
+            if (page.hasPrev) hint += "p 上一页 / ";
+            if (page.hasNext) hint += "n 下一页 / ";
+            hint += "j 学号 跳转 / q 返回]: ";
+
+            std::string cmd = readString(hint);
+            if (isQuit(cmd) || cmd.empty()) return;
+            if ((cmd == "n" || cmd == "N") && page.hasNext) {
+                page = mgr.nextPage(page, PAGE_SIZE, filter);
+            }
+            else if ((cmd == "p" || cmd == "P") && page.hasPrev) {
+                page = mgr.prevPage(page, PAGE_SIZE, filter);
+            }
+            else if (cmd[0] == 'j' || cmd[0] == 'J') {
+                std::string xh = cmd.substr(1);
+                xh.erase(0, xh.find_first_not_of(' '));
+                page = mgr.pageFrom(xh, PAGE_SIZE, filter);
+            }
+            else {
+                std::cout << "× 无效指令\n";
+            }
+        }
+    }
+
+    static void printTable(const std::vector<Student>& rows) {
+        if (rows.empty()) {
+            std::cout << "（无记录）\n";
+            return;
+        }
+        std::cout << std::left
+            << std::setw(14) << "学号"
+            << std::setw(10) << "姓名"
+            << std::setw(8) << "性别"
+            << std::setw(6) << "年龄"
+            << "专业\n";
+        std::cout << std::string(55, '-') << "\n";
+        for (const auto& s : rows) {
+            std::cout << std::left
+                << std::setw(14) << s.xh
+                << std::setw(10) << s.xm
+                << std::setw(8) << s.xb
+                << std::setw(6) << s.nl
+                << s.zy << "\n";
+        }
+    }
+
+    // ========== 6. 统计信息 ==========
+    static void handleStats(const StudentManager& mgr) {
+        std::cout << "\n--- 统计信息 ---\n"
+            << "总人数: " << mgr.count()
+            << "，平均年龄: " << std::fixed << std::setprecision(1) << mgr.averageAge() << "\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << "男: " << mgr.countOfXb("男") << "，女: " << mgr.countOfXb("女")
+            << "，其他: " << mgr.countOfXb("其他") << "\n\n";
+
+        std::cout << std::left << std::setw(20) << "专业"
+            << std::setw(8) << "人数" << std::setw(8) << "男" << std::setw(8) << "女" << "其他\n";
+        std::cout << std::string(50, '-') << "\n";
+        for (const auto& zy : Validator::getValidMajors()) {
+            std::cout << std::left << std::setw(20) << zy
+                << std::setw(8) << mgr.countOfZy(zy)
+                << std::setw(8) << mgr.countOfZyXb(zy, "男")
+                << std::setw(8) << mgr.countOfZyXb(zy, "女")
+                << mgr.countOfZyXb(zy, "其他") << "\n";
+        }
+
+        auto cache = mgr.queryCacheStats();
+        std::cout << "\n查询缓存: 命中 " << cache.hits << "，未命中 " << cache.misses
+            << "，命中率 " << std::fixed << std::setprecision(1) << cache.hitRate() * 100 << "%"
+            << "，失效 " << cache.invalidations << "，淘汰 " << cache.evictions
+            << "，当前 " << cache.entries << " 条\n";
+
+        auto filter = mgr.xhFilterStatistics();
+        std::cout << "学号过滤器: 查重 " << filter.checks << " 次，直接排除 " << filter.definitelyAbsent
+            << "，误判 " << filter.falsePositives << "（实测 " << std::setprecision(2)
+            << filter.observedFpr() * 100 << "%，理论 " << filter.estimatedFpr * 100 << "%）"
+            << "，重建 " << filter.rebuilds << " 次\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    // ========== 7. 查询语句 ==========
+    static void handleQuery(StudentManager& mgr) {
+        std::cout << "\n--- 查询语句（输入 q 返回）---\n"
+            << "例: SELECT xh, xm FROM students WHERE zy = 软件工程 AND nl BETWEEN 18 AND 20 ORDER BY nl DESC LIMIT 10\n"
+            << "    SELECT COUNT(*) WHERE xh LIKE '2023%'    语句前加 EXPLAIN 查看执行计划\n"
+            << "    UPDATE students SET zy = 人工智能 WHERE zy = 软件工程    DELETE FROM students WHERE nl > 25\n";
+        while (true) {
+            std::string text = readString("SQL> ");
+            if (isQuit(text)) return;
+            if (text.empty()) continue;
+            runStatement(mgr, text);
+        }
+    }
+
+    // ========== 8. 学年升级 ==========
+    static void handleRollover(StudentManager& mgr) {
+        std::cout << "\n--- 学年升级 (输入 q 可退出) ---\n";
+        StudentManager::RolloverRules rules;
+
+        std::string input = readString("年龄增加 (回车默认 1): ");
+        if (isQuit(input)) return;
+        if (!input.empty()) {
+            try {
+                rules.ageDelta = std::stoi(input);
+            }
+            catch (...) {
+                std::cout << "× 请输入有效数字\n";
+                return;
+            }
         }
-        else {
-            std::cout << "找到 " << results.size() << " 人:\n";
-            for (const auto& s : results) {
-                std::cout << s.xh << " - " << s.xm << " - "
-                    << s.xb << " - " << s.nl << "岁\n";
+
+        input = readString("归档学号小于此值的学生，如 2022 即 2021 级及以前 (回车跳过): ");
+        if (isQuit(input)) return;
+        rules.archiveXhBefore = input;
+
+        input = readString("归档升级后年龄超过此值的学生 (回车跳过): ");
+        if (isQuit(input)) return;
+        if (!input.empty()) {
+            try {
+                rules.archiveAgeAbove = std::stoi(input);
             }
+            catch (...) {
+                std::cout << "× 请输入有效数字\n";
+                return;
+            }
+        }
+
+        // 先预览：规则不合法（如学号界限不是数字）在此报错，并列出将归档的人数
+        StudentManager::RolloverResult result;
+        std::string errMsg;
+        if (!mgr.previewRollover(rules, result, errMsg)) {
+            std::cout << "× 无法升级: " << errMsg << "\n";
+            return;
         }
+        std::cout << "将归档 " << result.archived << " 名学生，其余 " << result.aged << " 名年龄增加 "
+            << rules.ageDelta << "\n";
+        std::string confirm = readString("确认执行学年升级? (y/n): ");
+        if (confirm != "y" && confirm != "Y") {
+            std::cout << "已取消\n";
+            return;
+        }
+
+        if (!mgr.rollover(rules, result, errMsg)) {
+            std::cout << "× 升级失败: " << errMsg << "\n";
+            return;
+        }
+        std::cout << "√ 已调整 " << result.aged << " 名学生的年龄，归档 " << result.archived << " 名";
+        if (result.archived) std::cout << "（" << JsonHelper::archivePathFor(mgr.getDataPath()) << "）";
+        std::cout << "\n";
+        if (!result.archiveWritten) std::cout << "警告：归档文件写入失败，保存时将重试\n";
+    }
+
+    static void printResult(const QueryResult& r) {
+        if (r.rows.empty()) {
+            std::cout << "（无记录）\n";
+            return;
+        }
+        for (const auto& c : r.columns) std::cout << std::left << std::setw(14) << c;
+        std::cout << "\n" << std::string(14 * r.columns.size(), '-') << "\n";
+        for (const auto& row : r.rows) {
+            for (const auto& cell : row) std::cout << std::left << std::setw(14) << cell;
+            std::cout << "\n";
+        }
+        if (!r.countOnly) std::cout << "共 " << r.rows.size() << " 条\n";
     }
 
 public:
+    // 编译并执行一条语句，结果输出到控制台（菜单与脚本模式共用）
+    static bool runStatement(StudentManager& mgr, const std::string& text) {
+        CompiledQuery q;
+        std::string errMsg;
+        if (!CompiledQuery::compile(text, q, errMsg)) {
+            std::cout << "× 语法错误: " << errMsg << "\n";
+            return false;
+        }
+        if (q.isMutation() && !q.isExplain()) {
+            size_t affected = 0;
+            if (!q.apply(mgr, affected, errMsg)) {
+                std::cout << "× 执行失败: " << errMsg << "\n";
+                return false;
+            }
+            std::cout << "√ 影响 " << affected << " 条记录\n";
+            return true;
+        }
+        QueryResult r = q.execute(mgr);
+        if (q.isExplain()) std::cout << r.plan.explain() << "\n";
+        else printResult(r);
+        return true;
+    }
+
     static void run() {
         auto& mgr = StudentManager::getInstance();
         std::cout << "系统启动，已加载 " << mgr.count() << " 条数据\n";
@@ -347,16 +566,57 @@ public:
             }
 
             switch (choice) {
-            case 1: handleAdd(); break;
-            case 2: handleDelete(); break;
-            case 3: handleModify(); break;
-            case 4: handleSearch(); break;
-            case 5: mgr.displayAll(); break;
+            case 1: handleAdd(mgr); break;
+            case 2: handleDelete(mgr); break;
+            case 3: handleModify(mgr); break;
+            case 4: handleSearch(mgr); break;
+            case 5: handleList(mgr); break;
+            case 6: handleStats(mgr); break;
+            case 7: handleQuery(mgr); break;
+            case 8: handleRollover(mgr); break;
             case 0:
                 std::cout << (mgr.save() ? "数据已保存，再见！\n" : "警告：保存失败！\n");
                 return;
             default:
-                std::cout << "× 无效选项，请输入 0-5\n";
+                std::cout << "× 无效选项，请输入 0-8\n";
+            }
+        }
+    }
+
+    // 只读跟随模式：打开同一数据文件，每次操作前先追赶主进程的变更日志
+    static void runFollower(const std::string& dataPath) {
+        auto follower = StudentManager::openFollower(dataPath);
+        StudentManager& mgr = *follower;
+        std::cout << "只读跟随模式，已加载 " << mgr.count() << " 条数据\n";
+
+        while (true) {
+            std::cout << "\n====== 学生信息管理系统（只读跟随） ======\n"
+                << "4. 查询学生（按专业）\n"
+                << "5. 显示全部学生\n"
+                << "6. 统计信息\n"
+                << "7. 查询语句\n"
+                << "9. 同步状态\n"
+                << "0. 退出\n"
+                << "==========================================\n";
+            int choice = readIntOrQuit("请选择: ");
+            if (choice == -999 || choice == 0) return;
+
+            mgr.catchUp();
+            switch (choice) {
+            case 4: handleSearch(mgr); break;
+            case 5: handleList(mgr); break;
+            case 6: handleStats(mgr); break;
+            case 7: handleQuery(mgr); break;
+            case 9: {
+                auto st = mgr.replicationStatus();
+                std::cout << "已回放至主进程提交 #" << st.appliedSeq
+                    << "，累计 " << st.appliedRecords << " 条记录，重新加载 " << st.reloads << " 次\n"
+                    << "复制延迟: 最近 " << st.lastLagMs << " ms，最大 " << st.maxLagMs << " ms\n"
+                    << "当前共 " << mgr.count() << " 人\n";
+                break;
+            }
+            default:
+                std::cout << "× 无效选项，请输入 0/4/5/6/7/9\n";
             }
         }
     }
@@ -0,0 +1,120 @@
+#pragma once
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// 最小完美哈希（hash-and-displace / CHD 思路）：n 个互不相同的键一一映射到 [0, n)
+// 构建：键按哈希分入约 n/4 个桶，从大桶到小桶依次为每个桶找一个位移值，使桶内所有键落到空位
+// 查询：一次字符串哈希 + 一次查位移表 + 一次整数混合，无冲突链；不在键集合中的键也会得到某个位置，
+// 调用方须核对该位置上存的键
+// 哈希值到区间的归约用乘法取高位（fastrange）代替取模，省去查询路径上的两次整数除法
+class MinimalPerfectHash {
+public:
+    // keys 须互不相同
+    void build(const std::vector<std::string_view>& keys) {
+        n = keys.size();
+        displace.clear();
+        if (n == 0) return;
+        // 最后放置的单键桶只剩少数空位，期望要试约 n 个位移；上限按 n 放大，使重建只在极少数情况下发生
+        maxDisplace = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(16ULL * n, 1024), UINT32_MAX));
+        // 极少数情况下两个键 64 位哈希相同或位移搜索过久，换种子重建
+        for (seed = 0;; ++seed) {
+            if (tryBuild(keys)) return;
+        }
+    }
+
+    size_t size() const { return n; }
+
+    size_t slotOf(std::string_view key) const {
+        if (n == 0) return 0;
+        uint64_t h = hashKey(key, seed);
+        return position(h, displace[bucketOf(h)]);
+    }
+
+    size_t memoryBytes() const { return displace.size() * sizeof(uint32_t); }
+
+private:
+    size_t n = 0;
+    uint64_t seed = 0;
+    std::vector<uint32_t> displace;  // 桶 → 位移值
+    uint32_t maxDisplace = 0;        // 每个桶尝试的位移值上限
+
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 终结函数
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    static uint64_t hashKey(std::string_view key, uint64_t seed) {
+        uint64_t h = 14695981039346656037ULL ^ mix(seed);  // FNV-1a
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        return mix(h);
+    }
+
+    // 取 32 位哈希与区间长度之积的高 32 位，均匀落在 [0, range)；键数不超过 32 位（行号即为 32 位）
+    static size_t reduce(uint64_t h, size_t range) {
+        return static_cast<size_t>(((h >> 32) * static_cast<uint64_t>(range)) >> 32);
+    }
+
+    size_t bucketOf(uint64_t h) const { return reduce(h, displace.size()); }
+
+    size_t position(uint64_t h, uint32_t d) const {
+        return reduce(mix(h + d * 0x9E3779B97F4A7C15ULL), n);
+    }
+
+    bool tryBuild(const std::vector<std::string_view>& keys) {
+        displace.assign(n / 4 + 1, 0);
+        // 按桶计数排序：同桶键的哈希连续存放，start[b] 为桶 b 的起点
+        std::vector<uint64_t> hashes(n), grouped(n);
+        std::vector<uint32_t> start(displace.size() + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            hashes[i] = hashKey(keys[i], seed);
+            ++start[bucketOf(hashes[i]) + 1];
+        }
+        for (size_t b = 1; b < start.size(); ++b) start[b] += start[b - 1];
+        std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (uint64_t h : hashes) grouped[fill[bucketOf(h)]++] = h;
+
+        auto sizeOf = [&](uint32_t b) { return start[b + 1] - start[b]; };
+        std::vector<uint32_t> order(displace.size());
+        for (size_t b = 0; b < order.size(); ++b) order[b] = static_cast<uint32_t>(b);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sizeOf(a) > sizeOf(b); });
+
+        // 已占用的位置用位图记录：后期大部分尝试都落在已占位置上，位图比字节数组更能留在缓存里
+        std::vector<uint64_t> taken((n + 63) / 64, 0);
+        auto isTaken = [&](size_t p) { return (taken[p >> 6] >> (p & 63)) & 1; };
+        std::vector<size_t> pos;
+        for (uint32_t b : order) {
+            if (sizeOf(b) == 0) break;  // 已按大小降序，之后都是空桶
+            const uint64_t* members = grouped.data() + start[b];
+            bool placed = false;
+            for (uint32_t d = 0; d < maxDisplace && !placed; ++d) {
+                pos.clear();
+                placed = true;
+                for (uint32_t k = 0; k < sizeOf(b); ++k) {
+                    size_t p = position(members[k], d);
+                    if (isTaken(p) || std::find(pos.begin(), pos.end(), p) != pos.end()) {
+                        placed = false;
+                        break;
+                    }
+                    pos.push_back(p);
+                }
+                if (placed) {
+                    displace[b] = d;
+                    for (size_t p : pos) taken[p >> 6] |= uint64_t(1) << (p & 63);
+                }
+            }
+            if (!placed) return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include "Student.h"
+#include "nlohmann/json.hpp"
+
+// 单条变更（事务暂存、日志写入与回放共用）
+struct Mutation {
+    enum class Type { Add, Delete, Update, AgeShift };
+
+    Type type = Type::Add;
+    Student stu;    // Add/Update 为完整记录；Delete 只使用 stu.xh
+    int delta = 0;  // AgeShift：全体学生年龄的增量
+};
+
+inline void to_json(nlohmann::json& j, const Mutation& m) {
+    switch (m.type) {
+    case Mutation::Type::Add:    j = { { "op", "add" }, { "stu", m.stu } }; break;
+    case Mutation::Type::Delete: j = { { "op", "del" }, { "xh", m.stu.xh } }; break;
+    case Mutation::Type::Update: j = { { "op", "upd" }, { "stu", m.stu } }; break;
+    case Mutation::Type::AgeShift: j = { { "op", "age" }, { "delta", m.delta } }; break;
+    }
+}
+
+inline void from_json(const nlohmann::json& j, Mutation& m) {
+    std::string op = j.at("op").get<std::string>();
+    if (op == "add") {
+        m.type = Mutation::Type::Add;
+        m.stu = j.at("stu").get<Student>();
+    }
+    else if (op == "del") {
+        m.type = Mutation::Type::Delete;
+        m.stu = Student();
+        m.stu.xh = j.at("xh").get<std::string>();
+    }
+    else if (op == "upd") {
+        m.type = Mutation::Type::Update;
+        m.stu = j.at("stu").get<Student>();
+    }
+    else if (op == "age") {
+        m.type = Mutation::Type::AgeShift;
+        m.stu = Student();
+        m.delta = j.at("delta").get<int>();
+    }
+    else {
+        throw std::runtime_error("unknown mutation op: " + op);
+    }
+}
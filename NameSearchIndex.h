@@ -0,0 +1,186 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+// 姓名模糊检索索引：按 UTF-8 字符切分的一元/二元 n-gram → 不同姓名
+// 只索引去重后的姓名（同名多人共用一项，引用计数），随录入/删除增量维护
+// 一元倒排按排名（首次出现位置、姓名长度、字典序）有序存放，单字检索只读前 limit 项
+class NameSearchIndex {
+public:
+    // 命中的姓名及排序依据
+    struct Match {
+        const std::string* name;
+        int kind;       // 0 完全相同，1 前缀，2 包含
+        size_t pos;     // 匹配起始字符位置
+        size_t length;  // 姓名字符数
+    };
+
+    void add(const std::string& name) {
+        auto it = names.find(name);
+        if (it != names.end()) {
+            ++it->second.count;
+            return;
+        }
+        std::vector<std::string> chars = splitChars(name);
+        it = names.emplace(name, Entry{ 1, chars.size() }).first;
+        const std::string* key = &it->first;
+        for (const auto& u : unigramsOf(chars)) unigrams[u.first].insert({ key, u.second, chars.size() });
+        for (const auto& b : bigramsOf(chars)) bigrams[b].insert(key);
+    }
+
+    void remove(const std::string& name) {
+        auto it = names.find(name);
+        if (it == names.end()) return;
+        if (--it->second.count > 0) return;
+        const std::string* key = &it->first;
+        std::vector<std::string> chars = splitChars(name);
+        for (const auto& u : unigramsOf(chars)) {
+            auto p = unigrams.find(u.first);
+            if (p == unigrams.end()) continue;
+            p->second.erase({ key, u.second, chars.size() });
+            if (p->second.empty()) unigrams.erase(p);
+        }
+        for (const auto& b : bigramsOf(chars)) {
+            auto p = bigrams.find(b);
+            if (p == bigrams.end()) continue;
+            p->second.erase(key);
+            if (p->second.empty()) bigrams.erase(p);
+        }
+        names.erase(it);
+    }
+
+    void clear() {
+        names.clear();
+        unigrams.clear();
+        bigrams.clear();
+    }
+
+    // 前缀检索：有序姓名表上 lower_bound 后读出全部前缀匹配，再按排名取前 limit 名
+    // 排名先看长度，字典序靠后的短姓名可能排在前面，不能只取字典序的前 limit 个
+    std::vector<Match> prefix(const std::string& pat, size_t limit) const {
+        std::vector<Match> result;
+        if (pat.empty()) return result;
+        for (auto it = names.lower_bound(pat); it != names.end(); ++it) {
+            if (it->first.compare(0, pat.size(), pat) != 0) break;
+            result.push_back({ &it->first, it->first == pat ? 0 : 1, 0, it->second.length });
+        }
+        size_t k = std::min(limit, result.size());
+        std::partial_sort(result.begin(), result.begin() + k, result.end(), byRank);
+        result.resize(k);
+        return result;
+    }
+
+    // 包含检索：单字按序读一元倒排的前 limit 项；多字取各二元倒排中最短的一条为候选，再逐个核对
+    std::vector<Match> contains(const std::string& pat, size_t limit) const {
+        std::vector<Match> result;
+        std::vector<std::string> chars = splitChars(pat);
+        if (chars.empty()) return result;
+
+        if (chars.size() == 1) {
+            // 倒排已按排名有序：位置 0 且长度 1 即完全相同，位置 0 为前缀，其余为包含
+            auto p = unigrams.find(chars[0]);
+            if (p == unigrams.end()) return result;
+            for (auto it = p->second.begin(); it != p->second.end() && result.size() < limit; ++it) {
+                int kind = it->pos > 0 ? 2 : (it->length == 1 ? 0 : 1);
+                result.push_back({ it->name, kind, it->pos, it->length });
+            }
+            return result;
+        }
+
+        const std::unordered_set<const std::string*>* candidates = nullptr;
+        for (size_t i = 0; i + 1 < chars.size(); ++i) {
+            auto p = bigrams.find(chars[i] + chars[i + 1]);
+            if (p == bigrams.end()) return result;
+            if (!candidates || p->second.size() < candidates->size()) candidates = &p->second;
+        }
+
+        for (const std::string* name : *candidates) {
+            size_t byte = name->find(pat);
+            if (byte == std::string::npos) continue;
+            size_t pos = countChars(*name, byte);
+            size_t len = names.find(*name)->second.length;
+            result.push_back({ name, pos > 0 ? 2 : (len == chars.size() ? 0 : 1), pos, len });
+        }
+        // 只对前 limit 名排序
+        size_t k = std::min(limit, result.size());
+        std::partial_sort(result.begin(), result.begin() + k, result.end(), byRank);
+        result.resize(k);
+        return result;
+    }
+
+    size_t distinctNames() const { return names.size(); }
+
+    // 按 UTF-8 编码切分为字符（非法字节按单字节处理）
+    static std::vector<std::string> splitChars(const std::string& s) {
+        std::vector<std::string> chars;
+        for (size_t i = 0; i < s.size();) {
+            size_t n = charWidth(s, i);
+            chars.push_back(s.substr(i, n));
+            i += n;
+        }
+        return chars;
+    }
+
+private:
+    struct Entry {
+        size_t count;   // 同名人数
+        size_t length;  // 字符数
+    };
+
+    // 一元倒排项：按 首次出现位置、姓名长度、姓名 排序，即单字检索的排名顺序
+    struct RankedName {
+        const std::string* name;
+        size_t pos;
+        size_t length;
+
+        bool operator<(const RankedName& o) const {
+            if (pos != o.pos) return pos < o.pos;
+            if (length != o.length) return length < o.length;
+            return *name < *o.name;
+        }
+    };
+
+    std::map<std::string, Entry> names;  // 姓名 → 人数与字符数（有序，供前缀检索）
+    std::unordered_map<std::string, std::set<RankedName>> unigrams;               // 单字 → 姓名（按排名有序）
+    std::unordered_map<std::string, std::unordered_set<const std::string*>> bigrams;  // 二元 → 姓名
+
+    static size_t charWidth(const std::string& s, size_t i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        size_t n = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+        return i + n > s.size() ? 1 : n;
+    }
+
+    // s 前 bytes 个字节中的字符数（不分配内存）
+    static size_t countChars(const std::string& s, size_t bytes) {
+        size_t n = 0;
+        for (size_t i = 0; i < bytes; i += charWidth(s, i)) ++n;
+        return n;
+    }
+
+    // 各单字及其首次出现位置
+    static std::unordered_map<std::string, size_t> unigramsOf(const std::vector<std::string>& chars) {
+        std::unordered_map<std::string, size_t> out;
+        for (size_t i = 0; i < chars.size(); ++i) out.emplace(chars[i], i);
+        return out;
+    }
+
+    // 二元 n-gram（去重）
+    static std::unordered_set<std::string> bigramsOf(const std::vector<std::string>& chars) {
+        std::unordered_set<std::string> out;
+        for (size_t i = 0; i + 1 < chars.size(); ++i) out.insert(chars[i] + chars[i + 1]);
+        return out;
+    }
+
+    // 完全相同 > 前缀 > 包含；其次匹配位置靠前、姓名较短、字典序
+    static bool byRank(const Match& a, const Match& b) {
+        if (a.kind != b.kind) return a.kind < b.kind;
+        if (a.pos != b.pos) return a.pos < b.pos;
+        if (a.length != b.length) return a.length < b.length;
+        return *a.name < *b.name;
+    }
+};
@@ -0,0 +1,149 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "StudentQuery.h"
+#include "Validator.h"
+
+// 查询结果缓存（LRU）：键为规范化后的查询条件，值为命中的行号列表（取用时再按行号读取当前记录）
+// 失效按代数判断：增删记录使行集代数 +1，原地修改使被改字段的代数 +1；
+// 每条缓存记下存入时的行集代数和查询所涉字段的代数，取用时任一不同即失效
+class QueryCache {
+public:
+    enum Field { Xh, Xm, Xb, Nl, Zy, FIELD_COUNT };
+
+    struct Generations {
+        uint64_t rows = 0;
+        uint64_t field[FIELD_COUNT] = {};
+    };
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t invalidations = 0;  // 因数据变更而丢弃的缓存
+        size_t evictions = 0;      // 因容量淘汰的缓存
+        size_t entries = 0;
+
+        double hitRate() const {
+            size_t total = hits + misses;
+            return total ? static_cast<double>(hits) / total : 0.0;
+        }
+    };
+
+    explicit QueryCache(size_t capacity = 64) : capacity(capacity) {}
+
+    // 规范化：固定字段顺序，性别归一化，同义写法得到同一个键
+    static std::string keyOf(const StudentQuery& q) {
+        std::string key;
+        auto put = [&](const char* tag, const std::string& v) {
+            key += tag;
+            key += '=';
+            key += v;
+            key += '\x1f';
+        };
+        if (q.xh) put("xh", *q.xh);
+        if (q.xhPrefix) put("xh^", *q.xhPrefix);
+        if (q.xhMin) put("xh>=", *q.xhMin);
+        if (q.xhMax) put("xh<=", *q.xhMax);
+        if (q.xm) put("xm", *q.xm);
+        if (q.xb) put("xb", Validator::normalizeXb(*q.xb));
+        if (q.nlMin) put("nl>=", std::to_string(*q.nlMin));
+        if (q.nlMax) put("nl<=", std::to_string(*q.nlMax));
+        if (q.zy) put("zy", *q.zy);
+        return key;
+    }
+
+    // 查询结果依赖的字段（学号不可修改，只随行集变化）
+    static unsigned fieldsOf(const StudentQuery& q) {
+        unsigned mask = 0;
+        if (q.xm) mask |= 1u << Xm;
+        if (q.xb) mask |= 1u << Xb;
+        if (q.nlMin || q.nlMax) mask |= 1u << Nl;
+        if (q.zy) mask |= 1u << Zy;
+        return mask;
+    }
+
+    // 命中返回 true 并给出行号与当时的执行计划；已失效的条目顺带删除
+    bool lookup(const std::string& key, const Generations& now, std::vector<uint32_t>& rowIds, QueryPlan& plan) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            ++counters.misses;
+            return false;
+        }
+        Entry& e = *it->second;
+        if (!isCurrent(e, now)) {
+            entries.erase(it->second);
+            index.erase(it);
+            ++counters.invalidations;
+            ++counters.misses;
+            return false;
+        }
+        entries.splice(entries.begin(), entries, it->second);  // 移到最近使用
+        rowIds = e.rowIds;
+        plan = e.plan;
+        ++counters.hits;
+        return true;
+    }
+
+    void store(const std::string& key, unsigned fields, const Generations& now,
+               std::vector<uint32_t> rowIds, const QueryPlan& plan) {
+        if (capacity == 0) return;
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entries.erase(it->second);
+            index.erase(it);
+        }
+        entries.push_front({ key, fields, now, std::move(rowIds), plan });
+        index[key] = entries.begin();
+        while (entries.size() > capacity) {
+            index.erase(entries.back().key);
+            entries.pop_back();
+            ++counters.evictions;
+        }
+    }
+
+    void clear() {
+        entries.clear();
+        index.clear();
+    }
+
+    void setCapacity(size_t n) {
+        capacity = n;
+        while (entries.size() > capacity) {
+            index.erase(entries.back().key);
+            entries.pop_back();
+            ++counters.evictions;
+        }
+    }
+
+    Stats stats() const {
+        Stats s = counters;
+        s.entries = entries.size();
+        return s;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        unsigned fields;
+        Generations gens;
+        std::vector<uint32_t> rowIds;
+        QueryPlan plan;
+    };
+
+    size_t capacity;
+    std::list<Entry> entries;  // 表头为最近使用
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    Stats counters;
+
+    static bool isCurrent(const Entry& e, const Generations& now) {
+        if (e.gens.rows != now.rows) return false;
+        for (int f = 0; f < FIELD_COUNT; ++f) {
+            if ((e.fields >> f) & 1 && e.gens.field[f] != now.field[f]) return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,319 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include "Student.h"
+#include "StudentQuery.h"
+#include "Validator.h"
+#include "StudentManager.h"
+
+// C++ 接口的声明式查询：条件在编译期组合成表达式类型，求值时全部内联，
+// 与手写 if 循环等价；顶层 AND 中能走索引的比较同时并入 StudentQuery 以选择访问路径
+//
+//   using namespace dsl;
+//   auto rows = where(nl >= 18 && zy == "软件工程").fetch(mgr);
+//   size_t n = where(xh.startsWith("2023") && !(xb == "男")).count(mgr);
+namespace dsl {
+
+enum class CmpOp { Eq, Ne, Lt, Le, Gt, Ge };
+
+// ---------- 字段 ----------
+// 每个字段给出取值方式，以及哪些比较可由索引回答（narrow 返回 false 表示只能逐行判断）
+// covers / coversPrefix 在编译期给出同样的判断（不考虑同一字段重复出现），用于生成剩余条件的类型
+struct XhField {
+    using value_type = std::string;
+    static constexpr bool coversPrefix = true;
+    static constexpr bool covers(CmpOp op) { return op == CmpOp::Eq || op == CmpOp::Ge || op == CmpOp::Le; }
+    static const std::string& get(const Student& s) { return s.xh; }
+    static bool narrow(StudentQuery& q, CmpOp op, const std::string& v) {
+        std::optional<std::string>* slot = op == CmpOp::Eq ? &q.xh
+            : op == CmpOp::Ge ? &q.xhMin : op == CmpOp::Le ? &q.xhMax : nullptr;
+        if (!slot || *slot) return false;
+        *slot = v;
+        return true;
+    }
+    static bool narrowPrefix(StudentQuery& q, const std::string& v) {
+        if (q.xhPrefix) return false;
+        q.xhPrefix = v;
+        return true;
+    }
+};
+
+struct XmField {
+    using value_type = std::string;
+    static constexpr bool coversPrefix = false;
+    static constexpr bool covers(CmpOp op) { return op == CmpOp::Eq; }
+    static const std::string& get(const Student& s) { return s.xm; }
+    static bool narrow(StudentQuery& q, CmpOp op, const std::string& v) {
+        if (op != CmpOp::Eq || q.xm) return false;
+        q.xm = v;
+        return true;
+    }
+    static bool narrowPrefix(StudentQuery&, const std::string&) { return false; }
+};
+
+// 性别按归一化后的值比较（男/M/m 视为同一值）
+struct XbField {
+    using value_type = std::string;
+    static constexpr bool coversPrefix = false;
+    static constexpr bool covers(CmpOp op) { return op == CmpOp::Eq; }
+    static std::string get(const Student& s) { return Validator::normalizeXb(s.xb); }
+    static std::string prepare(const std::string& v) { return Validator::normalizeXb(v); }
+    static bool narrow(StudentQuery& q, CmpOp op, const std::string& v) {
+        if (op != CmpOp::Eq || q.xb) return false;
+        q.xb = v;
+        return true;
+    }
+    static bool narrowPrefix(StudentQuery&, const std::string&) { return false; }
+};
+
+struct NlField {
+    using value_type = int;
+    static constexpr bool covers(CmpOp op) { return op != CmpOp::Ne; }
+    static int get(const Student& s) { return s.nl; }
+    static bool narrow(StudentQuery& q, CmpOp op, int v) {
+        auto tightenMin = [&](int n) { q.nlMin = q.nlMin ? std::max(*q.nlMin, n) : n; };
+        auto tightenMax = [&](int n) { q.nlMax = q.nlMax ? std::min(*q.nlMax, n) : n; };
+        switch (op) {
+        case CmpOp::Eq: tightenMin(v); tightenMax(v); return true;
+        case CmpOp::Ge: tightenMin(v); return true;
+        case CmpOp::Gt: tightenMin(v + 1); return true;
+        case CmpOp::Le: tightenMax(v); return true;
+        case CmpOp::Lt: tightenMax(v - 1); return true;
+        default: return false;
+        }
+    }
+};
+
+struct ZyField {
+    using value_type = std::string;
+    static constexpr bool coversPrefix = false;
+    static constexpr bool covers(CmpOp op) { return op == CmpOp::Eq; }
+    static const std::string& get(const Student& s) { return s.zy; }
+    static bool narrow(StudentQuery& q, CmpOp op, const std::string& v) {
+        if (op != CmpOp::Eq || q.zy) return false;
+        q.zy = v;
+        return true;
+    }
+    static bool narrowPrefix(StudentQuery&, const std::string&) { return false; }
+};
+
+// ---------- 表达式节点 ----------
+// 所有节点派生自 Expr<派生类>，运算符只对表达式类型生效
+template <typename D>
+struct Expr {
+    const D& self() const { return static_cast<const D&>(*this); }
+};
+
+template <typename F, CmpOp Op>
+struct Compare : Expr<Compare<F, Op>> {
+    typename F::value_type value;
+
+    explicit Compare(typename F::value_type v) : value(std::move(v)) {}
+
+    bool operator()(const Student& s) const {
+        if constexpr (Op == CmpOp::Eq) return F::get(s) == value;
+        else if constexpr (Op == CmpOp::Ne) return F::get(s) != value;
+        else if constexpr (Op == CmpOp::Lt) return F::get(s) < value;
+        else if constexpr (Op == CmpOp::Le) return F::get(s) <= value;
+        else if constexpr (Op == CmpOp::Gt) return F::get(s) > value;
+        else return F::get(s) >= value;
+    }
+
+    // 返回 false 表示编译期认为可并入、实际却未能并入（同一字段重复出现）
+    bool narrow(StudentQuery& q) const { return F::narrow(q, Op, value) || !F::covers(Op); }
+};
+
+template <typename F>
+struct StartsWith : Expr<StartsWith<F>> {
+    std::string prefix;
+
+    explicit StartsWith(std::string p) : prefix(std::move(p)) {}
+
+    bool operator()(const Student& s) const {
+        return F::get(s).compare(0, prefix.size(), prefix) == 0;
+    }
+
+    bool narrow(StudentQuery& q) const { return F::narrowPrefix(q, prefix) || !F::coversPrefix; }
+};
+
+// AND：两侧都可参与索引选择
+template <typename L, typename R>
+struct And : Expr<And<L, R>> {
+    L lhs;
+    R rhs;
+
+    And(L l, R r) : lhs(std::move(l)), rhs(std::move(r)) {}
+
+    bool operator()(const Student& s) const { return lhs(s) && rhs(s); }
+
+    bool narrow(StudentQuery& q) const {
+        bool l = lhs.narrow(q);
+        bool r = rhs.narrow(q);
+        return l && r;
+    }
+};
+
+// OR / NOT：无法用单个 StudentQuery 表达，只逐行判断
+template <typename L, typename R>
+struct Or : Expr<Or<L, R>> {
+    L lhs;
+    R rhs;
+
+    Or(L l, R r) : lhs(std::move(l)), rhs(std::move(r)) {}
+
+    bool operator()(const Student& s) const { return lhs(s) || rhs(s); }
+
+    bool narrow(StudentQuery&) const { return true; }
+};
+
+template <typename E>
+struct Not : Expr<Not<E>> {
+    E inner;
+
+    explicit Not(E e) : inner(std::move(e)) {}
+
+    bool operator()(const Student& s) const { return !inner(s); }
+
+    bool narrow(StudentQuery&) const { return true; }
+};
+
+// ---------- 字段引用与运算符 ----------
+template <typename F>
+struct Field {
+    using V = typename F::value_type;
+
+    static V prepare(const V& v) {
+        if constexpr (std::is_same<F, XbField>::value) return F::prepare(v);
+        else return v;
+    }
+
+    Compare<F, CmpOp::Eq> operator==(const V& v) const { return Compare<F, CmpOp::Eq>(prepare(v)); }
+    Compare<F, CmpOp::Ne> operator!=(const V& v) const { return Compare<F, CmpOp::Ne>(prepare(v)); }
+    Compare<F, CmpOp::Lt> operator<(const V& v) const { return Compare<F, CmpOp::Lt>(prepare(v)); }
+    Compare<F, CmpOp::Le> operator<=(const V& v) const { return Compare<F, CmpOp::Le>(prepare(v)); }
+    Compare<F, CmpOp::Gt> operator>(const V& v) const { return Compare<F, CmpOp::Gt>(prepare(v)); }
+    Compare<F, CmpOp::Ge> operator>=(const V& v) const { return Compare<F, CmpOp::Ge>(prepare(v)); }
+
+    StartsWith<F> startsWith(const std::string& prefix) const { return StartsWith<F>(prefix); }
+};
+
+constexpr Field<XhField> xh{};
+constexpr Field<XmField> xm{};
+constexpr Field<XbField> xb{};
+constexpr Field<NlField> nl{};
+constexpr Field<ZyField> zy{};
+
+template <typename L, typename R>
+And<L, R> operator&&(const Expr<L>& l, const Expr<R>& r) { return And<L, R>(l.self(), r.self()); }
+
+template <typename L, typename R>
+Or<L, R> operator||(const Expr<L>& l, const Expr<R>& r) { return Or<L, R>(l.self(), r.self()); }
+
+template <typename E>
+Not<E> operator!(const Expr<E>& e) { return Not<E>(e.self()); }
+
+// ---------- 剩余条件 ----------
+// 顶层 AND 中可并入 StudentQuery 的比较由 forEachMatch 精确保证，在类型层面替换为 Always 并消去，
+// 候选只再判断剩下的部分，与手写循环（自己填 StudentQuery 再判断其余条件）等价，逐行没有额外分支
+struct Always : Expr<Always> {
+    bool operator()(const Student&) const { return true; }
+};
+
+template <typename E>
+struct Residual {
+    using type = E;
+    static const E& of(const E& e) { return e; }
+};
+
+template <typename F, CmpOp Op>
+struct Residual<Compare<F, Op>> {
+    using type = std::conditional_t<F::covers(Op), Always, Compare<F, Op>>;
+    static type of(const Compare<F, Op>& e) {
+        if constexpr (F::covers(Op)) return Always();
+        else return e;
+    }
+};
+
+template <typename F>
+struct Residual<StartsWith<F>> {
+    using type = std::conditional_t<F::coversPrefix, Always, StartsWith<F>>;
+    static type of(const StartsWith<F>& e) {
+        if constexpr (F::coversPrefix) return Always();
+        else return e;
+    }
+};
+
+template <typename L, typename R>
+struct Residual<And<L, R>> {
+    using LT = typename Residual<L>::type;
+    using RT = typename Residual<R>::type;
+    using type = std::conditional_t<std::is_same<LT, Always>::value, RT,
+        std::conditional_t<std::is_same<RT, Always>::value, LT, And<LT, RT>>>;
+    static type of(const And<L, R>& e) {
+        if constexpr (std::is_same<LT, Always>::value) return Residual<R>::of(e.rhs);
+        else if constexpr (std::is_same<RT, Always>::value) return Residual<L>::of(e.lhs);
+        else return type(Residual<L>::of(e.lhs), Residual<R>::of(e.rhs));
+    }
+};
+
+// ---------- 执行 ----------
+// 索引条件只用于缩小候选；候选再由剩余条件判断，结果与逐行过滤一致。
+// 同一字段重复出现时（如两个 zy ==）只有第一个能并入，此时退回用完整表达式判断
+template <typename E>
+class Where {
+public:
+    explicit Where(E e) : expr(std::move(e)), rest(Residual<E>::of(expr)) { exact = expr.narrow(indexed); }
+
+    const StudentQuery& indexedPart() const { return indexed; }
+
+    template <typename Fn>
+    void forEach(const StudentManager& mgr, Fn fn, QueryPlan* plan = nullptr) const {
+        QueryPlan p;
+        size_t matched = 0;
+        auto run = [&](const auto& pred) {
+            mgr.forEachMatch(indexed, p, [&](const Student& s) {
+                if (!pred(s)) return;
+                ++matched;
+                fn(s);
+            });
+        };
+        if (exact) run(rest);
+        else run(expr);
+        p.rowsMatched = matched;
+        if (plan) *plan = p;
+    }
+
+    std::vector<Student> fetch(const StudentManager& mgr, QueryPlan* plan = nullptr) const {
+        std::vector<Student> result;
+        forEach(mgr, [&](const Student& s) { result.push_back(s); }, plan);
+        return result;
+    }
+
+    size_t count(const StudentManager& mgr) const {
+        size_t n = 0;
+        forEach(mgr, [&](const Student&) { ++n; });
+        return n;
+    }
+
+    // 排序 + LIMIT，复用有界堆 top-K
+    std::vector<Student> top(const StudentManager& mgr, const std::vector<OrderKey>& order, size_t limit,
+                             QueryPlan* plan = nullptr) const {
+        if (exact) return mgr.topKWhere(indexed, rest, order, limit, plan);
+        return mgr.topKWhere(indexed, expr, order, limit, plan);
+    }
+
+    bool operator()(const Student& s) const { return expr(s); }
+
+private:
+    E expr;
+    typename Residual<E>::type rest;
+    StudentQuery indexed;
+    bool exact = true;  // 编译期判定可并入的比较是否都已并入 indexed
+};
+
+template <typename E>
+Where<E> where(const Expr<E>& e) { return Where<E>(e.self()); }
+
+}  // namespace dsl
@@ -0,0 +1,515 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <optional>
+#include <algorithm>
+#include <cctype>
+#include "Student.h"
+#include "StudentQuery.h"
+#include "Validator.h"
+#include "StudentManager.h"
+
+// 查询语句执行结果
+struct QueryResult {
+    std::vector<std::string> columns;
+    std::vector<std::vector<std::string>> rows;
+    bool countOnly = false;
+    size_t count = 0;   // 命中条数（COUNT(*) 的结果）
+    QueryPlan plan;
+};
+
+// 简易查询语言：
+//   [EXPLAIN] SELECT * | COUNT(*) | 字段, ... [FROM students]
+//     [WHERE 条件 AND 条件 ...] [ORDER BY 字段 [ASC|DESC], ...] [LIMIT n]
+//   [EXPLAIN] DELETE [FROM students] WHERE 条件 AND ...
+//   [EXPLAIN] UPDATE [students] SET 字段 = 值, ... WHERE 条件 AND ...（学号不可修改）
+// DELETE / UPDATE 必须带 WHERE，命中记录整批作为一次提交；加 EXPLAIN 只显示执行计划，不修改数据
+// 字段: xh/学号 xm/姓名 xb/性别 nl/年龄 zy/专业
+// 条件: 字段 = != <> < <= > >= 值 | 字段 LIKE '前缀%' | nl BETWEEN a AND b
+// 语句只解析一次：能走索引的条件编译进 StudentQuery，其余编译为预先绑定字段与运算符的判断函数
+class CompiledQuery {
+public:
+    using Field = OrderKey::Field;
+
+    static bool compile(const std::string& text, CompiledQuery& out, std::string& errMsg) {
+        CompiledQuery q;
+        Parser parser(text);
+        if (!parser.tokenize(errMsg)) return false;
+        if (!q.parse(parser, errMsg)) return false;
+        out = std::move(q);
+        return true;
+    }
+
+    bool isExplain() const { return explain; }
+    bool isMutation() const { return kind != Kind::Select; }
+
+    // 执行 DELETE / UPDATE，affected 为删除或修改的条数
+    bool apply(StudentManager& mgr, size_t& affected, std::string& errMsg) const {
+        auto pred = [&](const Student& s) {
+            for (const auto& f : residual) {
+                if (!f(s)) return false;
+            }
+            return true;
+        };
+        if (kind == Kind::Delete) return mgr.eraseIf(query, pred, affected, errMsg);
+        if (kind == Kind::Update) {
+            auto change = [&](Student& s) {
+                for (const auto& a : assignments) {
+                    switch (a.first) {
+                    case Field::Xm: s.xm = a.second; break;
+                    case Field::Xb: s.xb = a.second; break;
+                    case Field::Nl: s.nl = std::stoi(a.second); break;
+                    case Field::Zy: s.zy = a.second; break;
+                    case Field::Xh: break;  // 解析时已拒绝
+                    }
+                }
+            };
+            return mgr.updateIf(query, pred, change, affected, errMsg);
+        }
+        errMsg = "不是 DELETE / UPDATE 语句";
+        return false;
+    }
+
+    QueryResult execute(const StudentManager& mgr) const {
+        QueryResult result;
+        result.countOnly = countOnly;
+        size_t matched = 0;
+        auto pred = [&](const Student& s) {
+            for (const auto& f : residual) {
+                if (!f(s)) return false;
+            }
+            ++matched;
+            return true;
+        };
+
+        if (countOnly) {
+            mgr.forEachMatch(query, result.plan, pred);
+            result.columns = { "COUNT(*)" };
+            result.rows.push_back({ std::to_string(matched) });
+        }
+        else {
+            std::vector<Student> rows = mgr.topKWhere(query, pred, order, limit, &result.plan);
+            for (Field f : projection) result.columns.push_back(fieldName(f));
+            for (const auto& s : rows) {
+                std::vector<std::string> cells;
+                for (Field f : projection) cells.push_back(fieldText(s, f));
+                result.rows.push_back(std::move(cells));
+            }
+        }
+
+        result.count = matched;
+        result.plan.rowsMatched = matched;
+        result.plan.residual.insert(result.plan.residual.end(), residualText.begin(), residualText.end());
+        return result;
+    }
+
+    static std::string fieldName(Field f) {
+        switch (f) {
+        case Field::Xh: return "xh";
+        case Field::Xm: return "xm";
+        case Field::Xb: return "xb";
+        case Field::Nl: return "nl";
+        case Field::Zy: return "zy";
+        }
+        return "";
+    }
+
+    static std::string fieldText(const Student& s, Field f) {
+        switch (f) {
+        case Field::Xh: return s.xh;
+        case Field::Xm: return s.xm;
+        case Field::Xb: return s.xb;
+        case Field::Nl: return std::to_string(s.nl);
+        case Field::Zy: return s.zy;
+        }
+        return "";
+    }
+
+private:
+    // ---------- 词法 ----------
+    struct Token {
+        enum class Kind { Word, String, Number, Op, Comma, LParen, RParen, Star, End };
+        Kind kind = Kind::End;
+        std::string text;
+    };
+
+    class Parser {
+    public:
+        explicit Parser(const std::string& text) : src(text) {}
+
+        bool tokenize(std::string& errMsg) {
+            size_t i = 0;
+            while (i < src.size()) {
+                unsigned char c = static_cast<unsigned char>(src[i]);
+                if (std::isspace(c)) { ++i; continue; }
+                Token t;
+                if (c == '\'' || c == '"') {
+                    size_t end = src.find(static_cast<char>(c), i + 1);
+                    if (end == std::string::npos) {
+                        errMsg = "引号未闭合";
+                        return false;
+                    }
+                    t.kind = Token::Kind::String;
+                    t.text = src.substr(i + 1, end - i - 1);
+                    i = end + 1;
+                }
+                else if (c == ',' || c == '(' || c == ')' || c == '*') {
+                    t.kind = c == ',' ? Token::Kind::Comma : c == '(' ? Token::Kind::LParen
+                        : c == ')' ? Token::Kind::RParen : Token::Kind::Star;
+                    t.text = std::string(1, static_cast<char>(c));
+                    ++i;
+                }
+                else if (c == '=' || c == '!' || c == '<' || c == '>') {
+                    t.kind = Token::Kind::Op;
+                    t.text = std::string(1, static_cast<char>(c));
+                    if (i + 1 < src.size() && (src[i + 1] == '=' || (c == '<' && src[i + 1] == '>'))) {
+                        t.text += src[i + 1];
+                    }
+                    if (t.text == "!") {
+                        errMsg = "无效运算符 !";
+                        return false;
+                    }
+                    i += t.text.size();
+                }
+                else {
+                    // 单词：关键字、字段名，或未加引号的值（如 软件工程、2023%）
+                    size_t start = i;
+                    while (i < src.size()) {
+                        unsigned char d = static_cast<unsigned char>(src[i]);
+                        if (std::isspace(d) || std::string(",()*=!<>'\"").find(static_cast<char>(d)) != std::string::npos) break;
+                        ++i;
+                    }
+                    t.text = src.substr(start, i - start);
+                    bool numeric = std::all_of(t.text.begin(), t.text.end(),
+                        [](char ch) { return std::isdigit(static_cast<unsigned char>(ch)); });
+                    t.kind = numeric ? Token::Kind::Number : Token::Kind::Word;
+                }
+                tokens.push_back(t);
+            }
+            tokens.push_back(Token());
+            return true;
+        }
+
+        const Token& peek() const { return tokens[pos]; }
+        Token next() { return pos + 1 < tokens.size() ? tokens[pos++] : tokens[pos]; }
+
+        // 当前为指定关键字（不区分大小写）则消费并返回 true
+        bool accept(const std::string& keyword) {
+            if (peek().kind != Token::Kind::Word || upper(peek().text) != keyword) return false;
+            ++pos;
+            return true;
+        }
+
+        static std::string upper(std::string s) {
+            for (auto& ch : s) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+            return s;
+        }
+
+    private:
+        std::string src;
+        std::vector<Token> tokens;
+        size_t pos = 0;
+    };
+
+    // ---------- 编译结果 ----------
+    enum class Kind { Select, Delete, Update };
+    Kind kind = Kind::Select;
+    bool explain = false;
+    bool countOnly = false;
+    std::vector<Field> projection;
+    StudentQuery query;                                          // 可由索引回答的条件
+    std::vector<std::function<bool(const Student&)>> residual;   // 其余条件
+    std::vector<std::string> residualText;
+    std::vector<OrderKey> order;
+    size_t limit = 0;                                            // 0 表示不限
+    std::vector<std::pair<Field, std::string>> assignments;      // UPDATE 的 SET 子句
+
+    static bool parseField(const std::string& name, Field& f) {
+        std::string n = Parser::upper(name);
+        if (n == "XH" || name == "学号") f = Field::Xh;
+        else if (n == "XM" || name == "姓名") f = Field::Xm;
+        else if (n == "XB" || name == "性别") f = Field::Xb;
+        else if (n == "NL" || name == "年龄") f = Field::Nl;
+        else if (n == "ZY" || name == "专业") f = Field::Zy;
+        else return false;
+        return true;
+    }
+
+    static bool expectField(Parser& p, Field& f, std::string& errMsg) {
+        Token t = p.next();
+        if (t.kind != Token::Kind::Word || !parseField(t.text, f)) {
+            errMsg = "未知字段: " + (t.text.empty() ? std::string("(语句结束)") : t.text);
+            return false;
+        }
+        return true;
+    }
+
+    static bool expectValue(Parser& p, std::string& value, std::string& errMsg) {
+        Token t = p.next();
+        if (t.kind != Token::Kind::String && t.kind != Token::Kind::Number && t.kind != Token::Kind::Word) {
+            errMsg = "缺少比较值";
+            return false;
+        }
+        value = t.text;
+        return true;
+    }
+
+    static bool toInt(const std::string& v, int& n, std::string& errMsg) {
+        if (v.empty() || v.size() > 9 || !std::all_of(v.begin(), v.end(),
+                [](char ch) { return std::isdigit(static_cast<unsigned char>(ch)); })) {
+            errMsg = "年龄必须是整数: " + v;
+            return false;
+        }
+        n = std::stoi(v);
+        return true;
+    }
+
+    bool parse(Parser& p, std::string& errMsg) {
+        explain = p.accept("EXPLAIN");
+        if (p.accept("DELETE")) {
+            kind = Kind::Delete;
+            if (p.accept("FROM")) p.next();
+            return parseMutationWhere(p, errMsg);
+        }
+        if (p.accept("UPDATE")) {
+            kind = Kind::Update;
+            if (!p.accept("SET")) {
+                p.next();  // 表名
+                if (!p.accept("SET")) {
+                    errMsg = "UPDATE 缺少 SET";
+                    return false;
+                }
+            }
+            if (!parseAssignments(p, errMsg)) return false;
+            return parseMutationWhere(p, errMsg);
+        }
+        if (!p.accept("SELECT")) {
+            errMsg = "语句须以 SELECT、DELETE 或 UPDATE 开头";
+            return false;
+        }
+        if (!parseProjection(p, errMsg)) return false;
+        if (p.accept("FROM")) p.next();  // 只有一张表，表名忽略
+        if (p.accept("WHERE")) {
+            do {
+                if (!parseCondition(p, errMsg)) return false;
+            } while (p.accept("AND"));
+        }
+        if (p.accept("ORDER")) {
+            if (!p.accept("BY")) {
+                errMsg = "ORDER 后缺少 BY";
+                return false;
+            }
+            do {
+                OrderKey k;
+                if (!expectField(p, k.field, errMsg)) return false;
+                if (p.accept("DESC")) k.desc = true;
+                else p.accept("ASC");
+                order.push_back(k);
+            } while (p.peek().kind == Token::Kind::Comma && (p.next(), true));
+        }
+        if (p.accept("LIMIT")) {
+            Token t = p.next();
+            if (t.kind != Token::Kind::Number) {
+                errMsg = "LIMIT 后须为数字";
+                return false;
+            }
+            limit = static_cast<size_t>(std::stoull(t.text));
+        }
+        if (p.peek().kind != Token::Kind::End) {
+            errMsg = "无法识别: " + p.peek().text;
+            return false;
+        }
+        return true;
+    }
+
+    // DELETE / UPDATE 的 WHERE 子句：必须有条件，不支持 ORDER BY / LIMIT
+    // 编译为计数查询，EXPLAIN 时按 SELECT COUNT(*) 执行以显示计划
+    bool parseMutationWhere(Parser& p, std::string& errMsg) {
+        if (!p.accept("WHERE")) {
+            errMsg = "DELETE / UPDATE 必须带 WHERE 条件";
+            return false;
+        }
+        do {
+            if (!parseCondition(p, errMsg)) return false;
+        } while (p.accept("AND"));
+        if (p.peek().kind != Token::Kind::End) {
+            errMsg = "无法识别: " + p.peek().text;
+            return false;
+        }
+        countOnly = true;
+        return true;
+    }
+
+    bool parseAssignments(Parser& p, std::string& errMsg) {
+        do {
+            Field f;
+            if (!expectField(p, f, errMsg)) return false;
+            if (f == Field::Xh) {
+                errMsg = "学号不能修改";
+                return false;
+            }
+            Token op = p.next();
+            if (op.kind != Token::Kind::Op || op.text != "=") {
+                errMsg = "SET 缺少 =";
+                return false;
+            }
+            std::string value;
+            if (!expectValue(p, value, errMsg)) return false;
+            int n;
+            if (f == Field::Nl && !toInt(value, n, errMsg)) return false;
+            assignments.emplace_back(f, value);
+        } while (p.peek().kind == Token::Kind::Comma && (p.next(), true));
+        return true;
+    }
+
+    bool parseProjection(Parser& p, std::string& errMsg) {
+        if (p.peek().kind == Token::Kind::Star) {
+            p.next();
+            projection = { Field::Xh, Field::Xm, Field::Xb, Field::Nl, Field::Zy };
+            return true;
+        }
+        if (p.accept("COUNT")) {
+            if (p.next().kind != Token::Kind::LParen || p.next().kind != Token::Kind::Star
+                || p.next().kind != Token::Kind::RParen) {
+                errMsg = "只支持 COUNT(*)";
+                return false;
+            }
+            countOnly = true;
+            return true;
+        }
+        do {
+            Field f;
+            if (!expectField(p, f, errMsg)) return false;
+            projection.push_back(f);
+        } while (p.peek().kind == Token::Kind::Comma && (p.next(), true));
+        return true;
+    }
+
+    bool parseCondition(Parser& p, std::string& errMsg) {
+        Field f;
+        if (!expectField(p, f, errMsg)) return false;
+
+        if (p.accept("BETWEEN")) {
+            std::string lo, hi;
+            if (!expectValue(p, lo, errMsg)) return false;
+            if (!p.accept("AND")) {
+                errMsg = "BETWEEN 缺少 AND";
+                return false;
+            }
+            if (!expectValue(p, hi, errMsg)) return false;
+            return addCompare(f, ">=", lo, errMsg) && addCompare(f, "<=", hi, errMsg);
+        }
+        if (p.accept("LIKE")) {
+            std::string pattern;
+            if (!expectValue(p, pattern, errMsg)) return false;
+            addLike(f, pattern);
+            return true;
+        }
+
+        Token op = p.next();
+        if (op.kind != Token::Kind::Op) {
+            errMsg = "缺少比较运算符";
+            return false;
+        }
+        std::string value;
+        if (!expectValue(p, value, errMsg)) return false;
+        return addCompare(f, op.text == "<>" ? "!=" : op.text, value, errMsg);
+    }
+
+    // 比较条件：能由索引回答的并入 query，否则编译为判断函数
+    bool addCompare(Field f, const std::string& op, const std::string& value, std::string& errMsg) {
+        if (f == Field::Nl) {
+            int n;
+            if (!toInt(value, n, errMsg)) return false;
+            // 严格比较换成闭区间端点，多个条件取交集
+            auto tightenMin = [&](int v) { query.nlMin = query.nlMin ? std::max(*query.nlMin, v) : v; };
+            auto tightenMax = [&](int v) { query.nlMax = query.nlMax ? std::min(*query.nlMax, v) : v; };
+            if (op == "=") { tightenMin(n); tightenMax(n); }
+            else if (op == ">=") tightenMin(n);
+            else if (op == ">") tightenMin(n + 1);
+            else if (op == "<=") tightenMax(n);
+            else if (op == "<") tightenMax(n - 1);
+            else {
+                residual.push_back([n](const Student& s) { return s.nl != n; });
+                residualText.push_back("nl != " + value);
+            }
+            return true;
+        }
+
+        std::optional<std::string>* slot = nullptr;
+        if (op == "=") {
+            slot = f == Field::Xh ? &query.xh : f == Field::Xm ? &query.xm
+                : f == Field::Xb ? &query.xb : &query.zy;
+        }
+        else if (f == Field::Xh && op == ">=") slot = &query.xhMin;
+        else if (f == Field::Xh && op == "<=") slot = &query.xhMax;
+        if (slot && !*slot) {
+            *slot = value;
+            return true;
+        }
+
+        // 其余比较：按字段与运算符选定判断函数，执行时不再解析；只有性别比较前需归一化
+        std::string v = f == Field::Xb ? Validator::normalizeXb(value) : value;
+        auto bind = [&](auto cmp) -> std::function<bool(const Student&)> {
+            auto test = [v, cmp](const std::string& x) { return cmp(x, v); };
+            if (f == Field::Xb) return [test](const Student& s) { return test(Validator::normalizeXb(s.xb)); };
+            return onField(f, test);
+        };
+        std::function<bool(const Student&)> fn;
+        if (op == "=") fn = bind(std::equal_to<>());
+        else if (op == "!=") fn = bind(std::not_equal_to<>());
+        else if (op == "<") fn = bind(std::less<>());
+        else if (op == "<=") fn = bind(std::less_equal<>());
+        else if (op == ">") fn = bind(std::greater<>());
+        else if (op == ">=") fn = bind(std::greater_equal<>());
+        else {
+            errMsg = "无效运算符: " + op;
+            return false;
+        }
+        residual.push_back(fn);
+        residualText.push_back(fieldName(f) + " " + op + " " + value);
+        return true;
+    }
+
+    // LIKE：学号 '前缀%' 走有序索引；其余模式（% 任意串，_ 任意一字节）逐行匹配
+    void addLike(Field f, const std::string& pattern) {
+        size_t pct = pattern.find_first_of("%_");
+        if (f == Field::Xh && !query.xhPrefix && pct == pattern.size() - 1 && pattern.back() == '%') {
+            query.xhPrefix = pattern.substr(0, pct);
+            return;
+        }
+        residual.push_back(onField(f, [pattern](const std::string& x) { return likeMatch(x, pattern); }));
+        residualText.push_back(fieldName(f) + " LIKE " + pattern);
+    }
+
+    // 字段取值在编译期选定：每个字符串字段实例化一个直接引用成员的判断函数，逐行不再分派、不复制
+    template <std::string Student::* Member, typename Test>
+    static std::function<bool(const Student&)> onMember(Test test) {
+        return [test](const Student& s) { return test(s.*Member); };
+    }
+
+    template <typename Test>
+    static std::function<bool(const Student&)> onField(Field f, Test test) {
+        switch (f) {
+        case Field::Xh: return onMember<&Student::xh>(test);
+        case Field::Xm: return onMember<&Student::xm>(test);
+        case Field::Xb: return onMember<&Student::xb>(test);
+        case Field::Zy: return onMember<&Student::zy>(test);
+        case Field::Nl: break;
+        }
+        return [test](const Student& s) { return test(std::to_string(s.nl)); };  // 年龄只在 LIKE 中按文本匹配
+    }
+
+    static bool likeMatch(const std::string& s, const std::string& pat) {
+        size_t si = 0, pi = 0, star = std::string::npos, mark = 0;
+        while (si < s.size()) {
+            if (pi < pat.size() && (pat[pi] == '_' || pat[pi] == s[si])) { ++si; ++pi; }
+            else if (pi < pat.size() && pat[pi] == '%') { star = pi++; mark = si; }
+            else if (star != std::string::npos) { pi = star + 1; si = ++mark; }
+            else return false;
+        }
+        while (pi < pat.size() && pat[pi] == '%') ++pi;
+        return pi == pat.size();
+    }
+};
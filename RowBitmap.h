@@ -0,0 +1,147 @@
+#pragma once
+#include <vector>
+#include <bitset>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROWBITMAP_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 行号位图：第 i 位表示行号 i 是否属于该取值（如某专业、某性别）
+// 行号回收复用，位图保持稠密，直接按 64 位字存储；与/或运算按 128 位一组处理
+class RowBitmap {
+public:
+    void set(uint32_t row) {
+        size_t w = row >> 6;
+        if (w >= words.size()) words.resize(w + 1, 0);
+        uint64_t mask = uint64_t(1) << (row & 63);
+        if (!(words[w] & mask)) {
+            words[w] |= mask;
+            ++ones;
+        }
+    }
+
+    void reset(uint32_t row) {
+        size_t w = row >> 6;
+        if (w >= words.size()) return;
+        uint64_t mask = uint64_t(1) << (row & 63);
+        if (words[w] & mask) {
+            words[w] &= ~mask;
+            --ones;
+        }
+    }
+
+    bool test(uint32_t row) const {
+        size_t w = row >> 6;
+        return w < words.size() && (words[w] >> (row & 63)) & 1;
+    }
+
+    size_t count() const { return ones; }
+    bool empty() const { return ones == 0; }
+
+    // 原始 64 位字（供按行号对齐的列式内核使用）
+    const uint64_t* data() const { return words.data(); }
+    size_t wordCount() const { return words.size(); }
+
+    void clear() {
+        words.clear();
+        ones = 0;
+    }
+
+    // 按行号升序遍历所有置位
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t bits = words[w];
+            while (bits) {
+                fn(static_cast<uint32_t>(w * 64 + ctz(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    // this |= other
+    void orWith(const RowBitmap& other) {
+        if (other.words.size() > words.size()) words.resize(other.words.size(), 0);
+        size_t n = other.words.size();
+        size_t i = 0;
+#ifdef ROWBITMAP_SSE2
+        for (; i + 2 <= n; i += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&words[i]));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&other.words[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&words[i]), _mm_or_si128(a, b));
+        }
+#endif
+        for (; i < n; ++i) words[i] |= other.words[i];
+        recount();
+    }
+
+    // this &= other
+    void andWith(const RowBitmap& other) {
+        size_t n = std::min(words.size(), other.words.size());
+        size_t i = 0;
+#ifdef ROWBITMAP_SSE2
+        for (; i + 2 <= n; i += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&words[i]));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&other.words[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&words[i]), _mm_and_si128(a, b));
+        }
+#endif
+        for (; i < n; ++i) words[i] &= other.words[i];
+        words.resize(n);
+        recount();
+    }
+
+    // |a & b|，不生成中间位图
+    static size_t andCount(const RowBitmap& a, const RowBitmap& b) {
+        size_t n = std::min(a.words.size(), b.words.size());
+        size_t total = 0;
+        size_t i = 0;
+#ifdef ROWBITMAP_SSE2
+        alignas(16) uint64_t lanes[2];
+        for (; i + 2 <= n; i += 2) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&a.words[i]));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.words[i]));
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_and_si128(x, y));
+            total += popcount(lanes[0]) + popcount(lanes[1]);
+        }
+#endif
+        for (; i < n; ++i) total += popcount(a.words[i] & b.words[i]);
+        return total;
+    }
+
+private:
+    std::vector<uint64_t> words;
+    size_t ones = 0;  // 置位数，set/reset 时维护，count() 为 O(1)
+
+    void recount() {
+        ones = 0;
+        for (uint64_t w : words) ones += popcount(w);
+    }
+
+    static size_t popcount(uint64_t x) {
+        return std::bitset<64>(x).count();
+    }
+
+    static unsigned ctz(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long idx;
+        _BitScanForward64(&idx, x);
+        return idx;
+#elif defined(_MSC_VER)
+        unsigned long idx;
+        if (_BitScanForward(&idx, static_cast<unsigned long>(x))) return idx;
+        _BitScanForward(&idx, static_cast<unsigned long>(x >> 32));
+        return idx + 32;
+#else
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+    }
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "Student.h"
+
+// 行存储：行号 → 学生记录，记录按 1024 行一块连续存放（块内无逐条分配）
+// 删除的行清空后进入空闲表，录入时优先复用；二级索引都按行号引用记录
+// 块可与快照共享（写时复制）：写入前若该块仍被快照引用，先复制一份再改，快照看到的块永不改变
+// 修改可能使指向该块的引用改指旧副本，因此对外只在两次修改之间提供指针/引用
+class RowStore {
+public:
+    using RowId = uint32_t;
+    static constexpr RowId NO_ROW = UINT32_MAX;
+    static constexpr size_t CHUNK = 1024;
+
+    struct Chunk {
+        Student records[CHUNK] = {};
+        uint8_t used[CHUNK] = {};  // 行是否有效
+    };
+    using SharedChunks = std::vector<std::shared_ptr<const Chunk>>;
+
+    RowId alloc(const Student& stu) {
+        ++live;
+        RowId id;
+        if (!freeRows.empty()) {
+            id = freeRows.back();
+            freeRows.pop_back();
+        }
+        else {
+            if (slots % CHUNK == 0) chunks.push_back(std::make_shared<Chunk>());
+            id = static_cast<RowId>(slots++);
+        }
+        Chunk& c = writable(id);
+        c.records[id % CHUNK] = stu;
+        c.used[id % CHUNK] = 1;
+        return id;
+    }
+
+    void release(RowId id) {
+        Chunk& c = writable(id);
+        c.records[id % CHUNK] = Student();
+        c.used[id % CHUNK] = 0;
+        freeRows.push_back(id);
+        --live;
+    }
+
+    void clear() {
+        chunks.clear();
+        freeRows.clear();
+        slots = 0;
+        live = 0;
+    }
+
+    void reserve(size_t n) {
+        chunks.reserve((n + CHUNK - 1) / CHUNK);
+    }
+
+    bool isLive(size_t id) const { return id < slots && chunks[id / CHUNK]->used[id % CHUNK]; }
+    const Student& operator[](size_t id) const { return chunks[id / CHUNK]->records[id % CHUNK]; }
+    Student& operator[](size_t id) { return writable(id).records[id % CHUNK]; }
+
+    size_t size() const { return live; }        // 有效记录数
+    size_t slotCount() const { return slots; }  // 行号上界（含空行）
+
+    // 按行号顺序遍历有效记录
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t id = 0; id < slots; ++id) {
+            const Chunk& c = *chunks[id / CHUNK];
+            if (c.used[id % CHUNK]) fn(static_cast<RowId>(id), c.records[id % CHUNK]);
+        }
+    }
+
+    // 共享当前全部块（只复制块指针，O(块数)）；之后的写入不影响返回的块
+    SharedChunks share() const {
+        return SharedChunks(chunks.begin(), chunks.end());
+    }
+
+private:
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    std::vector<RowId> freeRows;
+    size_t slots = 0;
+    size_t live = 0;
+
+    // 取可写的块：仍被快照共享时先复制（调用方持有写锁，新的共享只会在写锁内产生）
+    Chunk& writable(size_t id) {
+        std::shared_ptr<Chunk>& c = chunks[id / CHUNK];
+        if (c.use_count() > 1) c = std::make_shared<Chunk>(*c);
+        else std::atomic_thread_fence(std::memory_order_acquire);  // 与快照释放块时的读操作同步
+        return *c;
+    }
+};
@@ -0,0 +1,285 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+#include <memory>
+#include "Student.h"
+#include "StudentManager.h"
+#include "nlohmann/json.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#endif
+
+// 分片工作进程：每个分片由一个子进程（本程序以 --shard-worker 数据文件 启动）独占加载，
+// 协调进程经标准输入/输出管道收发请求，每行一条 JSON：
+//   请求 {"op":"add"|"update","student":{...}}  {"op":"delete"|"find","xh":...}
+//        {"op":"findByName","name":...}  {"op":"searchByZy","zy":...}  {"op":"count"}  {"op":"save"}
+//   应答 {"ok":true/false,"error":...,"students":[...],"count":n}
+class ShardWorker {
+public:
+    // 子进程主循环：逐行处理请求直到输入关闭；修改已逐条写入变更日志，退出时无需保存
+    static int serve(const std::string& dataPath, std::istream& in, std::ostream& out) {
+        StudentManager mgr(dataPath);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            out << handle(mgr, line).dump() << "\n";
+            out.flush();
+        }
+        return 0;
+    }
+
+private:
+    static nlohmann::json handle(StudentManager& mgr, const std::string& line) {
+        nlohmann::json resp = { {"ok", true} };
+        try {
+            nlohmann::json req = nlohmann::json::parse(line);
+            std::string op = req.at("op").get<std::string>();
+            std::string errMsg;
+            if (op == "add" || op == "update") {
+                Student stu = req.at("student").get<Student>();
+                bool ok = op == "add" ? mgr.addStudent(stu, errMsg) : mgr.updateStudent(stu, errMsg);
+                if (!ok) resp = { {"ok", false}, {"error", errMsg} };
+            }
+            else if (op == "delete") {
+                resp["ok"] = mgr.deleteByXh(req.at("xh").get<std::string>());
+            }
+            else if (op == "find") {
+                resp["students"] = nlohmann::json::array();
+                if (const Student* s = mgr.findByXh(req.at("xh").get<std::string>())) resp["students"].push_back(*s);
+            }
+            else if (op == "findByName") {
+                resp["students"] = nlohmann::json::array();
+                for (const Student& s : mgr.findByName(req.at("name").get<std::string>())) resp["students"].push_back(s);
+            }
+            else if (op == "searchByZy") {
+                resp["students"] = mgr.searchByZy(req.at("zy").get<std::string>());
+            }
+            else if (op == "count") {
+                resp["count"] = mgr.count();
+            }
+            else if (op == "save") {
+                if (!mgr.save()) resp = { {"ok", false}, {"error", "保存失败"} };
+            }
+            else {
+                resp = { {"ok", false}, {"error", "未知操作: " + op} };
+            }
+        }
+        catch (const std::exception& e) {
+            resp = { {"ok", false}, {"error", std::string("请求格式错误: ") + e.what()} };
+        }
+        return resp;
+    }
+};
+
+// 协调进程一侧的子进程句柄：启动工作进程并通过管道收发请求
+// send / receive 分开，便于先向全部分片发出请求、再依次收取应答，使各分片并行处理
+class WorkerProcess {
+public:
+    WorkerProcess(const WorkerProcess&) = delete;
+    WorkerProcess& operator=(const WorkerProcess&) = delete;
+
+    // exePath 为空时使用当前程序
+    static std::unique_ptr<WorkerProcess> spawn(const std::string& exePath, const std::string& dataPath,
+                                                std::string& errMsg) {
+        std::unique_ptr<WorkerProcess> w(new WorkerProcess());
+        if (!w->start(exePath.empty() ? selfPath() : exePath, dataPath, errMsg)) return nullptr;
+        return w;
+    }
+
+    ~WorkerProcess() {
+        // 关闭子进程输入即通知其退出
+#ifdef _WIN32
+        if (toChild) CloseHandle(toChild);
+        if (process) {
+            WaitForSingleObject(process, INFINITE);
+            CloseHandle(process);
+        }
+        if (fromChild) CloseHandle(fromChild);
+#else
+        if (toChild >= 0) close(toChild);
+        if (pid > 0) waitpid(pid, nullptr, 0);
+        if (fromChild >= 0) close(fromChild);
+#endif
+    }
+
+    bool send(const nlohmann::json& req) {
+        return writeAll(req.dump() + "\n");
+    }
+
+    bool receive(nlohmann::json& resp, std::string& errMsg) {
+        std::string line;
+        if (!readLine(line)) {
+            errMsg = "分片进程已退出";
+            return false;
+        }
+        try {
+            resp = nlohmann::json::parse(line);
+        }
+        catch (...) {
+            errMsg = "分片进程应答格式错误";
+            return false;
+        }
+        if (!resp.value("ok", false) && resp.contains("error")) {
+            errMsg = resp["error"].get<std::string>();
+        }
+        return true;
+    }
+
+    bool call(const nlohmann::json& req, nlohmann::json& resp, std::string& errMsg) {
+        if (!send(req)) {
+            errMsg = "分片进程已退出";
+            return false;
+        }
+        return receive(resp, errMsg);
+    }
+
+private:
+    WorkerProcess() = default;
+
+    std::string readBuf;
+
+#ifdef _WIN32
+    HANDLE process = NULL;
+    HANDLE toChild = NULL;
+    HANDLE fromChild = NULL;
+
+    static std::string selfPath() {
+        char buf[MAX_PATH] = { 0 };
+        DWORD len = GetModuleFileNameA(NULL, buf, MAX_PATH);
+        return std::string(buf, len);
+    }
+
+    bool start(const std::string& exePath, const std::string& dataPath, std::string& errMsg) {
+        SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
+        HANDLE childIn = NULL, childOut = NULL;
+        if (!CreatePipe(&childIn, &toChild, &sa, 0) || !CreatePipe(&fromChild, &childOut, &sa, 0)) {
+            if (childIn) CloseHandle(childIn);
+            errMsg = "无法创建管道";
+            return false;
+        }
+        // 只有子进程一端可继承
+        SetHandleInformation(toChild, HANDLE_FLAG_INHERIT, 0);
+        SetHandleInformation(fromChild, HANDLE_FLAG_INHERIT, 0);
+
+        STARTUPINFOA si = {};
+        si.cb = sizeof(si);
+        si.dwFlags = STARTF_USESTDHANDLES;
+        si.hStdInput = childIn;
+        si.hStdOutput = childOut;
+        si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+        PROCESS_INFORMATION pi = {};
+        std::string cmd = "\"" + exePath + "\" --shard-worker \"" + dataPath + "\"";
+        BOOL ok = CreateProcessA(NULL, &cmd[0], NULL, NULL, TRUE, 0, NULL, NULL, &si, &pi);
+        CloseHandle(childIn);
+        CloseHandle(childOut);
+        if (!ok) {
+            errMsg = "无法启动分片进程: " + exePath;
+            return false;
+        }
+        CloseHandle(pi.hThread);
+        process = pi.hProcess;
+        return true;
+    }
+
+    bool writeAll(const std::string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            DWORD n = 0;
+            if (!WriteFile(toChild, data.data() + done, static_cast<DWORD>(data.size() - done), &n, NULL)) return false;
+            done += n;
+        }
+        return true;
+    }
+
+    bool readSome(char* buf, size_t cap, size_t& got) {
+        DWORD n = 0;
+        if (!ReadFile(fromChild, buf, static_cast<DWORD>(cap), &n, NULL) || n == 0) return false;
+        got = n;
+        return true;
+    }
+#else
+    pid_t pid = -1;
+    int toChild = -1;
+    int fromChild = -1;
+
+    static std::string selfPath() {
+        char buf[4096];
+        ssize_t len = readlink("/proc/self/exe", buf, sizeof(buf));
+        return len > 0 ? std::string(buf, static_cast<size_t>(len)) : "";
+    }
+
+    bool start(const std::string& exePath, const std::string& dataPath, std::string& errMsg) {
+        int in[2], out[2];
+        if (pipe(in) != 0) {
+            errMsg = "无法创建管道";
+            return false;
+        }
+        if (pipe(out) != 0) {
+            close(in[0]);
+            close(in[1]);
+            errMsg = "无法创建管道";
+            return false;
+        }
+        // 父进程一端不能被之后启动的其他分片进程继承，否则关闭后子进程收不到输入结束
+        fcntl(in[1], F_SETFD, FD_CLOEXEC);
+        fcntl(out[0], F_SETFD, FD_CLOEXEC);
+        signal(SIGPIPE, SIG_IGN);  // 子进程意外退出时写入返回错误而不是终止协调进程
+        pid = fork();
+        if (pid == 0) {
+            dup2(in[0], 0);
+            dup2(out[1], 1);
+            close(in[0]); close(in[1]); close(out[0]); close(out[1]);
+            execl(exePath.c_str(), exePath.c_str(), "--shard-worker", dataPath.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        close(in[0]);
+        close(out[1]);
+        toChild = in[1];
+        fromChild = out[0];
+        if (pid < 0) {
+            errMsg = "无法启动分片进程: " + exePath;
+            return false;
+        }
+        return true;
+    }
+
+    bool writeAll(const std::string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = write(toChild, data.data() + done, data.size() - done);
+            if (n <= 0) return false;
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool readSome(char* buf, size_t cap, size_t& got) {
+        ssize_t n = read(fromChild, buf, cap);
+        if (n <= 0) return false;
+        got = static_cast<size_t>(n);
+        return true;
+    }
+#endif
+
+    bool readLine(std::string& line) {
+        size_t nl;
+        while ((nl = readBuf.find('\n')) == std::string::npos) {
+            char buf[65536];
+            size_t got = 0;
+            if (!readSome(buf, sizeof(buf), got)) return false;
+            readBuf.append(buf, got);
+        }
+        line = readBuf.substr(0, nl);
+        readBuf.erase(0, nl + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();  // Windows 文本模式输出的换行
+        return true;
+    }
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Student.h"
+#include "ShardWorker.h"
+
+// 按学号哈希分片：每个分片由独立的工作进程加载（独立数据文件与日志、独立地址空间），
+// 容量随进程数扩展；点操作路由到唯一分片，按姓名/专业查询下发到全部分片并行执行再汇总
+class ShardedStudentManager {
+private:
+    std::vector<std::unique_ptr<WorkerProcess>> workers;
+    std::string startError;
+
+    // 稳定哈希（FNV-1a）：分片归属写入了数据文件，不能依赖 std::hash 的实现
+    static uint32_t hashXh(std::string_view xh) {
+        uint32_t h = 2166136261u;
+        for (unsigned char c : xh) {
+            h ^= c;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // data.json → data.shard0.json, data.shard1.json, ...
+    static std::vector<std::string> shardPaths(const std::string& basePath, size_t shardCount) {
+        size_t slash = basePath.find_last_of("\\/");
+        size_t dot = basePath.find_last_of('.');
+        bool hasExt = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+        std::string stem = hasExt ? basePath.substr(0, dot) : basePath;
+        std::string ext = hasExt ? basePath.substr(dot) : ".json";
+
+        std::vector<std::string> paths;
+        for (size_t i = 0; i < shardCount; ++i) {
+            paths.push_back(stem + ".shard" + std::to_string(i) + ext);
+        }
+        return paths;
+    }
+
+    // 先向全部分片发出请求，各进程并行处理；再按分片顺序收取并拼接结果
+    std::vector<Student> scatterGather(const nlohmann::json& req) const {
+        std::vector<Student> result;
+        if (!ready()) return result;
+        std::vector<bool> sent;
+        for (const auto& w : workers) sent.push_back(w->send(req));
+        for (size_t i = 0; i < workers.size(); ++i) {
+            nlohmann::json resp;
+            std::string errMsg;
+            if (!sent[i] || !workers[i]->receive(resp, errMsg) || !resp.contains("students")) continue;
+            for (const auto& item : resp["students"]) result.push_back(item.get<Student>());
+        }
+        return result;
+    }
+
+    bool callShard(std::string_view xh, const nlohmann::json& req, nlohmann::json& resp, std::string& errMsg) const {
+        if (!ready()) {
+            errMsg = startError;
+            return false;
+        }
+        return workers[shardOf(xh)]->call(req, resp, errMsg);
+    }
+
+public:
+    // 分片数在数据目录的生命周期内必须保持不变；workerExe 为空时以当前程序（--shard-worker）作为工作进程
+    ShardedStudentManager(const std::string& basePath, size_t shardCount, const std::string& workerExe = "") {
+        for (const std::string& path : shardPaths(basePath, shardCount == 0 ? 1 : shardCount)) {
+            std::unique_ptr<WorkerProcess> w = WorkerProcess::spawn(workerExe, path, startError);
+            if (!w) {
+                workers.clear();
+                return;
+            }
+            workers.push_back(std::move(w));
+        }
+        // 各进程并行加载分片；都应答后才算就绪（进程虽已创建，程序路径错误等仍会使其立即退出）
+        for (auto& w : workers) w->send({ {"op", "count"} });
+        for (size_t i = 0; i < workers.size(); ++i) {
+            nlohmann::json resp;
+            if (!workers[i]->receive(resp, startError)) {
+                startError = "分片 " + std::to_string(i) + " 启动失败: " + startError;
+                workers.clear();
+                return;
+            }
+        }
+    }
+
+    ShardedStudentManager(const ShardedStudentManager&) = delete;
+    ShardedStudentManager& operator=(const ShardedStudentManager&) = delete;
+
+    // 全部工作进程是否已启动；失败原因见 error()
+    bool ready() const { return !workers.empty(); }
+    const std::string& error() const { return startError; }
+
+    size_t shardCount() const { return workers.size(); }
+    size_t shardOf(std::string_view xh) const { return hashXh(xh) % workers.size(); }
+
+    // ========== 点操作：路由到学号所在分片 ==========
+    bool addStudent(const Student& stu, std::string& errMsg) {
+        nlohmann::json resp;
+        return callShard(stu.xh, { {"op", "add"}, {"student", stu} }, resp, errMsg) && resp.value("ok", false);
+    }
+
+    bool deleteByXh(const std::string& xh) {
+        nlohmann::json resp;
+        std::string errMsg;
+        return callShard(xh, { {"op", "delete"}, {"xh", xh} }, resp, errMsg) && resp.value("ok", false);
+    }
+
+    bool updateStudent(const Student& stu, std::string& errMsg) {
+        nlohmann::json resp;
+        return callShard(stu.xh, { {"op", "update"}, {"student", stu} }, resp, errMsg) && resp.value("ok", false);
+    }
+
+    // 记录在工作进程中，按值取回
+    bool findByXh(std::string_view xh, Student& out) const {
+        nlohmann::json resp;
+        std::string errMsg;
+        if (!callShard(xh, { {"op", "find"}, {"xh", std::string(xh)} }, resp, errMsg)) return false;
+        if (!resp.contains("students") || resp["students"].empty()) return false;
+        out = resp["students"][0].get<Student>();
+        return true;
+    }
+
+    // ========== 查询：下发到全部分片再汇总 ==========
+    std::vector<Student> findByName(std::string_view name) const {
+        return scatterGather({ {"op", "findByName"}, {"name", std::string(name)} });
+    }
+
+    std::vector<Student> searchByZy(const std::string& zy) const {
+        return scatterGather({ {"op", "searchByZy"}, {"zy", zy} });
+    }
+
+    size_t count() const {
+        if (!ready()) return 0;
+        for (const auto& w : workers) w->send({ {"op", "count"} });
+        size_t total = 0;
+        for (const auto& w : workers) {
+            nlohmann::json resp;
+            std::string errMsg;
+            if (w->receive(resp, errMsg)) total += resp.value("count", size_t(0));
+        }
+        return total;
+    }
+
+    // 全部分片并行保存，任一失败返回 false
+    bool save() {
+        if (!ready()) return false;
+        std::vector<bool> sent;
+        for (auto& w : workers) sent.push_back(w->send({ {"op", "save"} }));
+        bool ok = true;
+        for (size_t i = 0; i < workers.size(); ++i) {
+            nlohmann::json resp;
+            std::string errMsg;
+            ok = sent[i] && workers[i]->receive(resp, errMsg) && resp.value("ok", false) && ok;
+        }
+        return ok;
+    }
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <functional>
+#include <unordered_map>
+#include <cstddef>
+
+// 透明哈希：配合 std::equal_to<>，unordered 容器可直接用 std::string_view / const char* 查找，
+// 不必先构造 std::string（C++20 异构查找）
+struct StringHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    size_t operator()(const std::string& s) const { return std::hash<std::string_view>{}(s); }
+    size_t operator()(const char* s) const { return std::hash<std::string_view>{}(s); }
+};
+
+template <typename V>
+using StringMap = std::unordered_map<std::string, V, StringHash, std::equal_to<>>;
@@ -4,7 +4,7 @@
 
 struct Student {
     std::string xh;  // 学号（12位，唯一）
-    std::string xm;  // 姓名（作为 multimap 的 key）
+    std::string xm;  // 姓名（姓名索引的 key，可重名）
     std::string xb;  // 性别
     int nl;          // 年龄
     std::string zy;  // 专业
@@ -1,43 +1,526 @@
 #pragma once
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <mutex>
+#include <future>
+#include <chrono>
 #include <algorithm>
+#include <iterator>
+#include <climits>
 #include <iostream>
 #include <iomanip>
 #include "Student.h"
+#include "Mutation.h"
+#include "StudentQuery.h"
+#include "NameSearchIndex.h"
+#include "RowBitmap.h"
+#include "LazyRange.h"
+#include "FlatHashMap.h"
+#include "RowStore.h"
+#include "FrozenStudentTable.h"
+#include "BloomFilter.h"
+#include "AgeKernels.h"
+#include "CohortIndex.h"
+#include "QueryCache.h"
 #include "Validator.h"
 #include "JsonHelper.h"
 
 class StudentManager {
 private:
-    // 核心容器：姓名 → 学生（一对多）
-    std::unordered_multimap<std::string, Student> students;
+    // 绑定的数据文件与变更日志
+    std::string dataPath;
+    std::string logPath;
 
-    StudentManager() {
-        JsonHelper::load(students);
+    // 核心存储：行号 → 学生，全部记录连续存放；删除后行号回收复用，二级索引都按行号存储
+    using RowId = RowStore::RowId;
+    RowStore rows;
+
+    // 姓名索引：姓名 → 同名链表头（开放寻址表），同名的下一行 / 上一行记在 nameNext / namePrev 中
+    // 双向链接使删除与改名时摘链为 O(1)，不必沿链查找前驱
+    FlatHashMap<std::string, RowId> nameHead;
+    std::vector<RowId> nameNext;
+    std::vector<RowId> namePrev;
+
+    // 学号索引：学号 → 行号（开放寻址表）；另有按学号有序的索引，供分页与有序遍历
+    FlatHashMap<std::string, RowId> xhIndex;
+    std::map<std::string, RowId, std::less<>> xhOrder;
+
+    // 学号布隆过滤器：录入前的查重先问过滤器，"一定不存在"时不必查学号索引
+    // 删除的学号无法从过滤器移除，累计较多时按当前学号重建
+    BloomFilter xhFilter;
+    size_t xhFilterStale = 0;  // 上次重建后删除的学号数
+
+    // 年龄桶索引：年龄 → 行号列表（年龄受 Validator 限制在 1-150，直接寻址）
+    // 0 号与 151 号桶收纳数据文件中超出范围的异常值
+    static constexpr int AGE_BUCKETS = 152;
+    std::vector<std::vector<RowId>> ageBuckets = std::vector<std::vector<RowId>>(AGE_BUCKETS);
+    std::vector<uint32_t> agePos;  // 行号 → 在所属年龄桶中的位置（删除时交换到末尾 O(1) 移除）
+
+    // 年龄列：行号 → 年龄（uint8 连续存放，供向量化聚合）；空行及超出 1-150 的异常值记为 0
+    std::vector<uint8_t> ageCol;
+
+    // 姓名 n-gram 索引：前缀 / 包含检索
+    NameSearchIndex nameSearch;
+
+    // 位图索引：专业 / 性别（归一化后）→ 行号位图，取值很少，适合按字做与/或
+    StringMap<RowBitmap> zyBitmaps;
+    StringMap<RowBitmap> xbBitmaps;
+
+    // 增量统计：专业×性别人数与年龄总和（专业、性别各自的人数即位图置位数）
+    std::unordered_map<std::string, size_t> zyXbCounts;
+    uint64_t nlSum = 0;
+
+    // 学号分组索引：年级/学院/班级等分段 → 成员与年龄、专业分布
+    CohortIndex cohortIndex;
+
+    // 查询结果缓存与各索引的变更代数（增删 → 行集代数，原地修改 → 对应字段代数）
+    QueryCache::Generations gens;
+    mutable QueryCache queryCache;
+    mutable std::mutex cacheMtx;
+
+    // 写操作互斥：每次提交（单条或批量）只加锁一次；创建快照时只在共享块指针期间持有
+    mutable std::mutex writeMtx;
+
+    // MVCC：每次提交版本号 +1；快照按版本共享，最后一个读者释放后自动回收
+    // 快照数据：与行存储写时复制共享的块 + 按学号排好的记录指针
+    struct SnapshotData {
+        RowStore::SharedChunks chunks;
+        std::vector<const Student*> order;
+    };
+    uint64_t version = 0;
+    mutable std::map<uint64_t, std::weak_ptr<const SnapshotData>> snapshots;
+
+    // 内存状态已包含的最后一条日志序号：随数据文件一起保存，回放时跳过不大于它的记录，
+    // 数据文件已替换而日志尚未清空时崩溃，重启回放也不会重复应用（如学年升级的相对年龄调整）
+    uint64_t journalSeq = 0;
+
+public:
+    // 只读跟随的复制进度
+    struct ReplicationStatus {
+        uint64_t appliedSeq = 0;     // 已回放到的主进程提交序号
+        size_t appliedRecords = 0;   // 累计回放的日志记录数
+        size_t reloads = 0;          // 因主进程保存（清空日志）而重新加载数据文件的次数
+        long long lastLagMs = 0;     // 最近一条记录从主进程提交到本进程回放的延迟
+        long long maxLagMs = 0;
+        long long lastSyncMs = 0;    // 最近一次 catchUp 的时间
+    };
+
+    // 学号过滤器统计
+    struct XhFilterStats {
+        size_t checks = 0;          // 查重次数
+        size_t definitelyAbsent = 0;  // 过滤器直接判定不存在的次数
+        size_t falsePositives = 0;  // 过滤器判定可能存在、索引中却没有的次数
+        size_t rebuilds = 0;
+        double estimatedFpr = 0.0;  // 按当前填充度估算的理论误判率
+
+        // 实测误判率：不存在的学号中被过滤器误判为可能存在的比例
+        double observedFpr() const {
+            size_t negatives = definitelyAbsent + falsePositives;
+            return negatives ? static_cast<double>(falsePositives) / negatives : 0.0;
+        }
+    };
+
+    // 分页结果：游标是本页首尾学号，翻页时从游标处在有序索引上继续，不受中间增删影响
+    struct Page {
+        std::vector<Student> rows;
+        bool hasPrev = false;
+        bool hasNext = false;
+
+        std::string firstXh() const { return rows.empty() ? "" : rows.front().xh; }
+        std::string lastXh() const { return rows.empty() ? "" : rows.back().xh; }
+    };
+
+    // 同名记录区间：沿同名链遍历；冻结后改为遍历冻结表中连续存放的同名行号
+    // 与 findByXh 返回的指针一样，只在下一次修改之前有效
+    class NameRange {
+    public:
+        class iterator {
+        public:
+            iterator(const RowStore* rows, const std::vector<RowStore::RowId>* next, RowStore::RowId id)
+                : rows(rows), next(next), id(id) {}
+            iterator(const RowStore* rows, const uint32_t* pos)
+                : rows(rows), pos(pos) {}
+
+            const Student& operator*() const { return (*rows)[current()]; }
+            const Student* operator->() const { return &(*rows)[current()]; }
+            iterator& operator++() {
+                if (next) id = (*next)[id];
+                else ++pos;
+                return *this;
+            }
+            bool operator==(const iterator& o) const { return id == o.id && pos == o.pos; }
+            bool operator!=(const iterator& o) const { return !(*this == o); }
+
+        private:
+            const RowStore* rows;
+            const std::vector<RowStore::RowId>* next = nullptr;  // 非空为同名链，否则为行号列表
+            RowStore::RowId id = RowStore::NO_ROW;
+            const uint32_t* pos = nullptr;
+
+            RowStore::RowId current() const { return next ? id : *pos; }
+        };
+
+        NameRange(const RowStore& rows, const std::vector<RowStore::RowId>& next, RowStore::RowId head)
+            : rows(&rows), next(&next), head(head) {}
+        NameRange(const RowStore& rows, const uint32_t* first, size_t count)
+            : rows(&rows), first(first), count(count) {}
+
+        iterator begin() const { return next ? iterator(rows, next, head) : iterator(rows, first); }
+        iterator end() const { return next ? iterator(rows, next, RowStore::NO_ROW) : iterator(rows, first + count); }
+        bool empty() const { return next ? head == RowStore::NO_ROW : count == 0; }
+
+        size_t size() const {
+            if (!next) return count;
+            size_t n = 0;
+            for (RowStore::RowId id = head; id != RowStore::NO_ROW; id = (*next)[id]) ++n;
+            return n;
+        }
+
+    private:
+        const RowStore* rows;
+        const std::vector<RowStore::RowId>* next = nullptr;
+        RowStore::RowId head = RowStore::NO_ROW;
+        const uint32_t* first = nullptr;
+        size_t count = 0;
+    };
+
+private:
+    // 只读跟随模式：拒绝写入，通过 catchUp() 追赶主进程的变更日志
+    bool readOnly = false;
+    std::streamoff logOffset = 0;  // 已回放到的日志字节位置
+    std::string logHead;           // 已回放日志的第一行；变化说明主进程已保存并重写日志
+    ReplicationStatus repl;
+
+    // 已提交、尚未写入归档文件的学年升级批次：批次号 → 归档记录
+    std::vector<std::pair<std::string, std::vector<Student>>> pendingArchives;
+
+    // 冻结后的只读表；非空即表示已冻结，拒绝一切修改
+    // 冻结时行按学号重排，行号即冻结表的行号：学号 / 姓名查找改走冻结表，
+    // 学号索引、同名链与学号过滤器只服务于修改与查找，随即释放
+    std::shared_ptr<const FrozenStudentTable> frozen;
+
+    // 学号过滤器的命中统计（查重在只读路径上，故为 mutable）
+    mutable XhFilterStats xhFilterCounters;
+
+    void rebuildIndex(const std::vector<Student>& loaded) {
+        ++gens.rows;
+        rows.clear();
+        rows.reserve(loaded.size());
+        if (frozen) {
+            releaseLookupIndexes();
+        }
+        else {
+            nameHead.clear();
+            nameNext.clear();
+            namePrev.clear();
+            xhIndex.clear();
+            xhIndex.reserve(loaded.size());
+            xhFilter.reset(loaded.size() * 2);
+            xhFilterStale = 0;
+        }
+        xhOrder.clear();
+        for (auto& bucket : ageBuckets) bucket.clear();
+        agePos.clear();
+        ageCol.clear();
+        nameSearch.clear();
+        zyBitmaps.clear();
+        xbBitmaps.clear();
+        zyXbCounts.clear();
+        nlSum = 0;
+        cohortIndex.clear();
+        for (const auto& stu : loaded) {
+            // 数据文件中学号重复时只保留第一条（冻结时的重排来自有序索引，不会重复）
+            if (!frozen && xhIndex.contains(stu.xh)) continue;
+            insertRecord(stu);
+        }
+    }
+
+    // 冻结后释放只服务于修改与逐条查找的结构（赋值为空对象才会归还内存）
+    void releaseLookupIndexes() {
+        xhIndex = FlatHashMap<std::string, RowId>();
+        nameHead = FlatHashMap<std::string, RowId>();
+        std::vector<RowId>().swap(nameNext);
+        std::vector<RowId>().swap(namePrev);
+        xhFilter = BloomFilter();
+        xhFilterStale = 0;
+    }
+
+    // 学号 → 行号：冻结后走冻结表（行号与冻结表一致）
+    RowId rowOf(std::string_view xh) const {
+        if (frozen) {
+            size_t i = frozen->indexOf(xh);
+            return i == FrozenStudentTable::NPOS ? RowStore::NO_ROW : static_cast<RowId>(i);
+        }
+        const RowId* id = xhIndex.find(xh);
+        return id ? *id : RowStore::NO_ROW;
+    }
+
+    RowId allocRow(const Student& stu) {
+        RowId id = rows.alloc(stu);
+        if (id >= agePos.size()) {
+            agePos.resize(id + 1, 0);
+            ageCol.resize(id + 1, 0);
+            if (!frozen) {
+                nameNext.resize(id + 1, RowStore::NO_ROW);
+                namePrev.resize(id + 1, RowStore::NO_ROW);
+            }
+        }
+        return id;
+    }
+
+    // 同名链：新行插在链头
+    void linkName(RowId id) {
+        RowId* head = nameHead.insert(rows[id].xm, RowStore::NO_ROW).first;
+        nameNext[id] = *head;
+        namePrev[id] = RowStore::NO_ROW;
+        if (*head != RowStore::NO_ROW) namePrev[*head] = id;
+        *head = id;
+    }
+
+    // 前驱与后继直接可得，只有摘下链头时才查一次姓名表
+    void unlinkName(RowId id) {
+        RowId prev = namePrev[id], next = nameNext[id];
+        if (next != RowStore::NO_ROW) namePrev[next] = prev;
+        if (prev != RowStore::NO_ROW) {
+            nameNext[prev] = next;
+        }
+        else if (RowId* head = nameHead.find(rows[id].xm)) {
+            if (next == RowStore::NO_ROW) nameHead.erase(rows[id].xm);
+            else *head = next;
+        }
+        nameNext[id] = namePrev[id] = RowStore::NO_ROW;
+    }
+
+    static int ageBucketOf(int nl) {
+        return nl < 1 ? 0 : (nl > 150 ? AGE_BUCKETS - 1 : nl);
+    }
+
+    // 年龄桶：加入桶尾；移出时把桶尾交换到空位，O(1)
+    void addToAgeBucket(RowId id, int nl) {
+        auto& bucket = ageBuckets[ageBucketOf(nl)];
+        agePos[id] = static_cast<uint32_t>(bucket.size());
+        bucket.push_back(id);
+    }
+
+    void removeFromAgeBucket(RowId id, int nl) {
+        auto& bucket = ageBuckets[ageBucketOf(nl)];
+        RowId last = bucket.back();
+        bucket[agePos[id]] = last;
+        agePos[last] = agePos[id];
+        bucket.pop_back();
+    }
+
+    static uint8_t ageColValue(int nl) {
+        return Validator::isValidNl(nl) ? static_cast<uint8_t>(nl) : 0;
+    }
+
+    // 二级索引维护：录入、删除、加载与回放经过 indexRow / unindexRow，原地修改经过 reindexRow
+    void indexRow(RowId id, const Student& stu) {
+        addToAgeBucket(id, stu.nl);
+        ageCol[id] = ageColValue(stu.nl);
+        nameSearch.add(stu.xm);
+        zyBitmaps[stu.zy].set(id);
+        xbBitmaps[Validator::normalizeXb(stu.xb)].set(id);
+        ++zyXbCounts[zyXbKey(stu.zy, stu.xb)];
+        nlSum += stu.nl;
+        cohortIndex.add(id, stu);
+    }
+
+    void unindexRow(RowId id, const Student& stu) {
+        removeFromAgeBucket(id, stu.nl);
+        ageCol[id] = 0;
+        nameSearch.remove(stu.xm);
+        zyBitmaps[stu.zy].reset(id);
+        xbBitmaps[Validator::normalizeXb(stu.xb)].reset(id);
+        --zyXbCounts[zyXbKey(stu.zy, stu.xb)];
+        nlSum -= stu.nl;
+        cohortIndex.remove(id, stu);
+    }
+
+    // 原地修改（学号不变）：只更新取值变化的字段涉及的索引，未改的字段不碰
+    void reindexRow(RowId id, const Student& before, const Student& after) {
+        if (before.xm != after.xm) {
+            nameSearch.remove(before.xm);
+            nameSearch.add(after.xm);
+        }
+        if (before.nl != after.nl) {
+            if (ageBucketOf(before.nl) != ageBucketOf(after.nl)) {
+                removeFromAgeBucket(id, before.nl);
+                addToAgeBucket(id, after.nl);
+            }
+            ageCol[id] = ageColValue(after.nl);
+            nlSum -= before.nl;
+            nlSum += after.nl;
+        }
+        bool zyChanged = before.zy != after.zy;
+        if (zyChanged) {
+            zyBitmaps[before.zy].reset(id);
+            zyBitmaps[after.zy].set(id);
+        }
+        bool xbChanged = before.xb != after.xb
+            && Validator::normalizeXb(before.xb) != Validator::normalizeXb(after.xb);
+        if (xbChanged) {
+            xbBitmaps[Validator::normalizeXb(before.xb)].reset(id);
+            xbBitmaps[Validator::normalizeXb(after.xb)].set(id);
+        }
+        if (zyChanged || xbChanged) {
+            --zyXbCounts[zyXbKey(before.zy, before.xb)];
+            ++zyXbCounts[zyXbKey(after.zy, after.xb)];
+        }
+        cohortIndex.update(before, after);
+    }
+
+    static std::string zyXbKey(const std::string& zy, const std::string& xb) {
+        return zy + '\x1f' + Validator::normalizeXb(xb);
+    }
+
+    const RowBitmap* bitmapOf(const StringMap<RowBitmap>& maps, std::string_view key) const {
+        auto it = maps.find(key);
+        return it == maps.end() ? nullptr : &it->second;
     }
 
-    // 内部方法：检查学号是否已存在（O(n)遍历）
-    bool xhExists(const std::string& xh) const {
-        for (const auto& pair : students) {
-            if (pair.second.xh == xh) return true;
+    Page scanForward(std::map<std::string, RowId, std::less<>>::const_iterator it, size_t pageSize,
+                     const StudentQuery* filter) const {
+        Page page;
+        page.hasPrev = hasMatchBefore(it, filter);
+        for (; it != xhOrder.end(); ++it) {
+            const Student& s = rows[it->second];
+            if (filter && !filter->matches(s)) continue;
+            if (page.rows.size() == pageSize) {
+                page.hasNext = true;  // 多看到一条即说明还有下一页
+                break;
+            }
+            page.rows.push_back(s);
+        }
+        return page;
+    }
+
+    bool hasMatchBefore(std::map<std::string, RowId, std::less<>>::const_iterator it, const StudentQuery* filter) const {
+        while (it != xhOrder.begin()) {
+            --it;
+            if (!filter || filter->matches(rows[it->second])) return true;
         }
         return false;
     }
 
-public:
-    static StudentManager& getInstance() {
-        static StudentManager instance;
-        return instance;
+    // 按学号顺序遍历满足前缀 / 上下界的行，fn 返回 false 时提前停止；代价与区间大小成正比
+    template <typename Fn>
+    void forEachInXhRange(const StudentQuery& q, Fn fn) const {
+        std::string from = q.xhPrefix ? *q.xhPrefix : "";
+        if (q.xhMin && *q.xhMin > from) from = *q.xhMin;
+        for (auto it = xhOrder.lower_bound(from); it != xhOrder.end(); ++it) {
+            const std::string& xh = it->first;
+            if (q.xhPrefix && xh.compare(0, q.xhPrefix->size(), *q.xhPrefix) != 0) break;
+            if (q.xhMax && xh > *q.xhMax) break;
+            if (!fn(rows[it->second])) break;
+        }
     }
 
-    StudentManager(const StudentManager&) = delete;
-    StudentManager& operator=(const StudentManager&) = delete;
+    // 按排序后的姓名展开为学生记录，最多 limit 条
+    std::vector<Student> expandNames(const std::vector<NameSearchIndex::Match>& matches, size_t limit) const {
+        std::vector<Student> result;
+        for (const auto& m : matches) {
+            for (const Student& s : findByName(*m.name)) {
+                if (result.size() >= limit) break;
+                result.push_back(s);
+            }
+            if (result.size() >= limit) break;
+        }
+        return result;
+    }
 
-    // ========== FR-1/FR-2: 录入学生 ==========
-    bool addStudent(const Student& stu, std::string& errMsg) {
-        // 校验
+    // 遍历年龄在 [lo, hi] 内的行；只有边界的异常值桶需要逐行比对
+    template <typename Fn>
+    void forEachInAgeRange(int lo, int hi, Fn fn) const {
+        if (lo > hi) return;
+        int first = ageBucketOf(lo), last = ageBucketOf(hi);
+        for (int b = first; b <= last; ++b) {
+            bool exact = b != 0 && b != AGE_BUCKETS - 1;
+            for (RowId id : ageBuckets[b]) {
+                const Student& s = rows[id];
+                if (exact || (s.nl >= lo && s.nl <= hi)) fn(s);
+            }
+        }
+    }
+
+    size_t ageRangeEstimate(int lo, int hi) const {
+        if (lo > hi) return 0;
+        size_t n = 0;
+        for (int b = ageBucketOf(lo); b <= ageBucketOf(hi); ++b) n += ageBuckets[b].size();
+        return n;
+    }
+
+    // 启动时回放上次保存之后的变更日志
+    void replayLog() {
+        std::vector<nlohmann::json> records;
+        if (!JsonHelper::loadLog(logPath, records)) return;
+        for (const auto& rec : records) {
+            applyLogRecord(rec);
+        }
+    }
+
+    // 回放一条日志记录（启动恢复与只读跟随共用），无法应用的记录直接跳过
+    void applyLogRecord(const nlohmann::json& rec) {
+        try {
+            if (!rec.contains("ops")) return;  // 保存标记
+            uint64_t seq = rec.value("seq", journalSeq + 1);
+            if (seq <= journalSeq) return;  // 已包含在数据文件中
+            std::vector<Mutation> ops = rec.at("ops").get<std::vector<Mutation>>();
+            std::string errMsg;
+            if (!checkMutations(ops, errMsg)) return;
+            applyMutations(ops);
+            ++version;
+            journalSeq = seq;
+            // 学年升级归档的记录：只由主进程补写归档文件（按批次号去重）
+            if (rec.contains("archive") && !readOnly) {
+                pendingArchives.emplace_back(rec["archive"].at("batch").get<std::string>(),
+                    rec["archive"].at("students").get<std::vector<Student>>());
+            }
+
+            ++repl.appliedRecords;
+            repl.appliedSeq = rec.value("seq", repl.appliedSeq + 1);
+            if (rec.contains("ts")) {
+                repl.lastLagMs = nowMs() - rec["ts"].get<long long>();
+                repl.maxLagMs = std::max(repl.maxLagMs, repl.lastLagMs);
+            }
+        }
+        catch (...) {
+            // 忽略格式错误的记录
+        }
+    }
+
+    static long long nowMs() {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    // 内部方法：检查学号是否已存在；过滤器判定不存在时不查索引
+    bool xhExists(std::string_view xh) const {
+        ++xhFilterCounters.checks;
+        if (!xhFilter.mayContain(xh)) {
+            ++xhFilterCounters.definitelyAbsent;
+            return false;
+        }
+        bool found = xhIndex.contains(xh);
+        if (!found) ++xhFilterCounters.falsePositives;
+        return found;
+    }
+
+    // 按当前学号重建过滤器，预留一倍增长空间
+    void rebuildXhFilter() {
+        xhFilter.reset(rows.size() * 2);
+        for (const auto& kv : xhIndex) xhFilter.add(kv.first);
+        xhFilterStale = 0;
+        ++xhFilterCounters.rebuilds;
+    }
+
+    // 字段校验（录入与修改共用）
+    static bool validateStudent(const Student& stu, std::string& errMsg) {
         if (!Validator::isValidXh(stu.xh)) {
             errMsg = "学号格式错误（需12位数字）";
             return false;
@@ -54,65 +537,1164 @@ public:
             errMsg = "专业不在允许列表中";
             return false;
         }
-        // 学号唯一性
-        if (xhExists(stu.xh)) {
-            errMsg = "学号已存在";
+        return true;
+    }
+
+    // 整批校验：按顺序模拟执行，批内学号冲突同样报错
+    bool checkMutations(const std::vector<Mutation>& ops, std::string& errMsg) const {
+        std::unordered_map<std::string, bool> staged;  // 批内学号 → 执行到当前位置时是否存在
+        std::unordered_set<std::string> addedInBatch;
+        auto exists = [&](const std::string& xh) {
+            auto it = staged.find(xh);
+            return it != staged.end() ? it->second : xhExists(xh);
+        };
+
+        for (size_t i = 0; i < ops.size(); ++i) {
+            const Mutation& m = ops[i];
+            std::string prefix = ops.size() > 1 ? "第 " + std::to_string(i + 1) + " 条: " : "";
+            switch (m.type) {
+            case Mutation::Type::Add:
+                if (!validateStudent(m.stu, errMsg)) {
+                    errMsg = prefix + errMsg;
+                    return false;
+                }
+                if (exists(m.stu.xh)) {
+                    errMsg = prefix + (addedInBatch.count(m.stu.xh) ? "学号在本批次中重复" : "学号已存在");
+                    return false;
+                }
+                staged[m.stu.xh] = true;
+                addedInBatch.insert(m.stu.xh);
+                break;
+            case Mutation::Type::Delete:
+                if (!exists(m.stu.xh)) {
+                    errMsg = prefix + "学号不存在";
+                    return false;
+                }
+                staged[m.stu.xh] = false;
+                break;
+            case Mutation::Type::Update:
+                if (!validateStudent(m.stu, errMsg)) {
+                    errMsg = prefix + errMsg;
+                    return false;
+                }
+                if (!exists(m.stu.xh)) {
+                    errMsg = prefix + "学号不存在";
+                    return false;
+                }
+                break;
+            case Mutation::Type::AgeShift:
+                if (!checkAgeShift(ops, staged, m.delta, errMsg)) {
+                    errMsg = prefix + errMsg;
+                    return false;
+                }
+                break;
+            }
+        }
+        return true;
+    }
+
+    // 年龄整体调整：批内只允许另有删除（先删后调），删除后剩余的有效年龄调整后须仍在 1-150 内
+    bool checkAgeShift(const std::vector<Mutation>& ops, const std::unordered_map<std::string, bool>& staged,
+                       int delta, std::string& errMsg) const {
+        size_t shifts = 0;
+        for (const auto& m : ops) {
+            if (m.type == Mutation::Type::Add || m.type == Mutation::Type::Update) {
+                errMsg = "年龄整体调整不能与录入或修改同批提交";
+                return false;
+            }
+            if (m.type == Mutation::Type::AgeShift) ++shifts;
+        }
+        if (shifts > 1) {
+            errMsg = "每批只能有一次年龄整体调整";
             return false;
         }
 
-        students.insert({ stu.xm, stu });  // 姓名为 key
+        std::vector<size_t> remaining(AGE_BUCKETS);
+        for (int a = 0; a < AGE_BUCKETS; ++a) remaining[a] = ageBuckets[a].size();
+        for (const auto& kv : staged) {
+            if (kv.second) continue;
+            const RowId* id = xhIndex.find(kv.first);
+            if (id) --remaining[ageBucketOf(rows[*id].nl)];
+        }
+        for (int a = 1; a < AGE_BUCKETS - 1; ++a) {
+            if (remaining[a] && !Validator::isValidNl(a + delta)) {
+                errMsg = "调整后年龄超出范围（1-150）：有 " + std::to_string(remaining[a]) + " 名 "
+                    + std::to_string(a) + " 岁的学生";
+                return false;
+            }
+        }
         return true;
     }
 
-    // ========== FR-3: 按姓名查找（返回迭代器范围） ==========
-    auto findByName(const std::string& name) {
-        return students.equal_range(name);  // O(1) 查找同名所有人
+    void eraseRecord(const std::string& xh) {
+        const RowId* idx = xhIndex.find(xh);
+        if (!idx) return;
+        RowId id = *idx;
+        unindexRow(id, rows[id]);
+        unlinkName(id);
+        xhOrder.erase(xh);
+        xhIndex.erase(xh);
+        rows.release(id);
+        ++gens.rows;
+        ++xhFilterStale;
+        if (xhFilterStale > 64 && xhFilterStale > rows.size() / 4) rebuildXhFilter();
     }
 
-    // ========== FR-3: 按学号删除 ==========
-    bool deleteByXh(const std::string& xh) {
-        for (auto it = students.begin(); it != students.end(); ++it) {
-            if (it->second.xh == xh) {
-                students.erase(it);
+    void insertRecord(const Student& stu) {
+        RowId id = allocRow(stu);
+        xhOrder[stu.xh] = id;
+        if (!frozen) {
+            xhIndex.insert(stu.xh, id);
+            if (xhFilter.insertedCount() >= xhFilter.plannedKeys()) rebuildXhFilter();  // 重建时已含本条
+            else xhFilter.add(stu.xh);
+            linkName(id);
+        }
+        indexRow(id, rows[id]);
+        ++gens.rows;
+    }
+
+    // 应用已校验的变更：容器与索引在同一遍内更新
+    void applyMutations(const std::vector<Mutation>& ops) {
+        for (const auto& m : ops) {
+            switch (m.type) {
+            case Mutation::Type::Add:
+                insertRecord(m.stu);
+                break;
+            case Mutation::Type::Delete:
+                eraseRecord(m.stu.xh);
+                break;
+            case Mutation::Type::Update: {
+                // 原地更新，行号不变；只更新变化字段的索引，姓名变化时改挂到新姓名的同名链
+                RowId id = *xhIndex.find(m.stu.xh);
+                Student& cur = rows[id];
+                bool renamed = cur.xm != m.stu.xm;
+                reindexRow(id, cur, m.stu);
+                if (renamed) {
+                    unlinkName(id);
+                    ++gens.field[QueryCache::Xm];
+                }
+                if (cur.xb != m.stu.xb) ++gens.field[QueryCache::Xb];
+                if (cur.nl != m.stu.nl) ++gens.field[QueryCache::Nl];
+                if (cur.zy != m.stu.zy) ++gens.field[QueryCache::Zy];
+                cur = m.stu;
+                if (renamed) linkName(id);
+                break;
+            }
+            case Mutation::Type::AgeShift:
+                shiftAges(m.delta);
+                break;
+            }
+        }
+    }
+
+    // 全体年龄加 delta（已校验有效年龄调整后仍在 1-150 内）
+    // 年龄桶整桶平移、年龄列走向量内核、分组统计平移分布；记录本身按行更新一遍
+    // 异常年龄（0 号与 151 号桶）的记录单独摘下再按新年龄挂回
+    void shiftAges(int delta) {
+        if (delta == 0) return;
+        std::vector<RowId> outliers = ageBuckets[0];
+        outliers.insert(outliers.end(), ageBuckets[AGE_BUCKETS - 1].begin(), ageBuckets[AGE_BUCKETS - 1].end());
+        for (RowId id : outliers) unindexRow(id, rows[id]);
+
+        std::vector<std::vector<RowId>> shifted(AGE_BUCKETS);
+        size_t moved = 0;
+        for (int a = 1; a < AGE_BUCKETS - 1; ++a) {
+            if (ageBuckets[a].empty()) continue;
+            moved += ageBuckets[a].size();
+            shifted[a + delta] = std::move(ageBuckets[a]);  // 桶内位置不变，agePos 无需改动
+        }
+        ageBuckets = std::move(shifted);
+        AgeKernels::shift(ageCol.data(), ageCol.size(), delta);
+        nlSum += static_cast<int64_t>(delta) * static_cast<int64_t>(moved);
+        cohortIndex.shiftAges(delta);
+
+        for (size_t id = 0; id < rows.slotCount(); ++id) {
+            if (rows.isLive(id)) rows[id].nl += delta;
+        }
+        for (RowId id : outliers) indexRow(id, rows[id]);
+        ++gens.field[QueryCache::Nl];
+    }
+
+    // 提交：一次加锁、整批校验、一次写日志、一遍更新索引
+    bool commitMutations(const std::vector<Mutation>& ops, std::string& errMsg) {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        return commitLocked(ops, errMsg);
+    }
+
+    // 同 commitMutations，调用方已持有 writeMtx（按条件批量修改时选行与提交在同一次加锁内）
+    // extra 中的字段一并写入该条日志（如学年升级的归档记录）
+    bool commitLocked(const std::vector<Mutation>& ops, std::string& errMsg,
+                      const nlohmann::json& extra = nlohmann::json::object()) {
+        if (!writable(errMsg)) return false;
+        if (ops.empty()) return true;
+        if (!checkMutations(ops, errMsg)) return false;
+        nlohmann::json record = { { "seq", journalSeq + 1 }, { "ts", nowMs() }, { "ops", ops } };
+        record.update(extra);
+        if (!JsonHelper::appendLog(logPath, record)) {
+            errMsg = "写入变更日志失败";
+            return false;
+        }
+        applyMutations(ops);
+        ++version;
+        ++journalSeq;
+        return true;
+    }
+
+    bool writable(std::string& errMsg) const {
+        if (readOnly) {
+            errMsg = "只读跟随模式，不能修改数据";
+            return false;
+        }
+        if (frozen) {
+            errMsg = "数据集已冻结，不能修改数据";
+            return false;
+        }
+        return true;
+    }
+
+    // 全部记录按学号排列（有序索引已排好，无需再排序；调用方持有 writeMtx）
+    std::vector<Student> sortedRecords() const {
+        std::vector<Student> sorted;
+        sorted.reserve(rows.size());
+        for (const auto& kv : xhOrder) sorted.push_back(rows[kv.second]);
+        return sorted;
+    }
+
+    // 清理已无读者持有的旧版本（调用方持有 writeMtx）
+    void collectSnapshots() const {
+        for (auto it = snapshots.begin(); it != snapshots.end();) {
+            if (it->second.expired()) it = snapshots.erase(it);
+            else ++it;
+        }
+    }
+
+public:
+    // 绑定到指定数据文件（如按校区/院系各一个）；各实例互不共享状态，可在不同线程并行加载
+    explicit StudentManager(const std::string& dataPath)
+        : dataPath(dataPath), logPath(JsonHelper::logPathFor(dataPath)) {
+        std::vector<Student> loaded;
+        JsonHelper::load(dataPath, loaded, journalSeq);
+        rebuildIndex(loaded);
+        replayLog();
+    }
+
+    // 默认实例：exe 同目录下的 data.json
+    static StudentManager& getInstance() {
+        static StudentManager instance(JsonHelper::defaultDataPath());
+        return instance;
+    }
+
+    // 每个数据文件一个线程并行加载，返回顺序与 paths 一致
+    static std::vector<std::unique_ptr<StudentManager>> openAll(const std::vector<std::string>& paths) {
+        std::vector<std::future<std::unique_ptr<StudentManager>>> loading;
+        for (const auto& path : paths) {
+            loading.push_back(std::async(std::launch::async, [path] {
+                return std::unique_ptr<StudentManager>(new StudentManager(path));
+            }));
+        }
+        std::vector<std::unique_ptr<StudentManager>> managers;
+        for (auto& f : loading) {
+            managers.push_back(f.get());
+        }
+        return managers;
+    }
+
+    const std::string& getDataPath() const { return dataPath; }
+
+    // ========== 只读跟随：与主进程共用数据文件，持续回放其变更日志 ==========
+    static std::unique_ptr<StudentManager> openFollower(const std::string& dataPath) {
+        std::unique_ptr<StudentManager> follower(new StudentManager(dataPath));
+        follower->readOnly = true;
+        follower->pendingArchives.clear();  // 归档文件只由主进程写
+        // 构造时已回放现有日志，从日志末尾继续跟随
+        std::vector<std::string> consumed;
+        JsonHelper::readLogTail(follower->logPath, follower->logOffset, consumed);
+        if (!consumed.empty()) follower->logHead = consumed.front();
+        // 启动时回放的是历史记录，不计入复制延迟
+        follower->repl.lastLagMs = follower->repl.maxLagMs = 0;
+        follower->repl.lastSyncMs = nowMs();
+        return follower;
+    }
+
+    bool isReadOnly() const { return readOnly; }
+
+    // ========== 冻结：转为只读紧凑表（最小完美哈希查找），此后拒绝一切修改 ==========
+    // 适合已结束学期的名册等不再变化的数据；findByXh / findByName 改走冻结表，学号哈希索引与同名链随即释放
+    // 冻结后的表也可由 frozenTable() 取得，脱离管理器单独使用
+    bool freeze(std::string& errMsg) {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        if (frozen) return true;
+        std::vector<Student> sorted = sortedRecords();
+        FrozenStudentTable table;
+        if (!FrozenStudentTable::build(sorted, table, errMsg)) return false;
+        frozen = std::make_shared<const FrozenStudentTable>(std::move(table));
+        // 行号须与冻结表（按学号有序）一致；刚从数据文件加载且未修改时已是如此，否则按学号重排
+        RowId expect = 0;
+        bool inOrder = rows.slotCount() == rows.size();
+        for (auto it = xhOrder.begin(); inOrder && it != xhOrder.end(); ++it) inOrder = it->second == expect++;
+        if (inOrder) releaseLookupIndexes();
+        else rebuildIndex(sorted);  // 已冻结，重建时不再建学号索引与同名链
+        return true;
+    }
+
+    bool isFrozen() const {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        return frozen != nullptr;
+    }
+
+    XhFilterStats xhFilterStatistics() const {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        XhFilterStats st = xhFilterCounters;
+        st.estimatedFpr = xhFilter.estimatedFpr();
+        return st;
+    }
+
+    std::shared_ptr<const FrozenStudentTable> frozenTable() const {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        return frozen;
+    }
+
+    // 回放主进程新追加的日志；主进程保存后日志被清空，则重新加载数据文件
+    bool catchUp() {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        if (!readOnly || frozen) return false;  // 冻结后不再追赶
+
+        // 日志首行变化说明主进程已保存并重写日志（首行是新的保存标记）；
+        // 尚未读到任何日志时，只有首行是保存标记才说明其间发生过保存
+        std::string head = JsonHelper::readLogHead(logPath);
+        bool saved = logHead.empty() && logOffset == 0 ? JsonHelper::isSaveMarker(head) : head != logHead;
+        if (saved) {
+            std::vector<Student> fresh;
+            uint64_t freshSeq = 0;
+            if (!JsonHelper::load(dataPath, fresh, freshSeq)) return false;  // 数据文件正在写入，下次再试
+            rebuildIndex(fresh);
+            journalSeq = freshSeq;
+            ++version;
+            logOffset = 0;
+            logHead.clear();
+            ++repl.reloads;
+        }
+
+        std::streamoff start = logOffset;
+        std::vector<std::string> lines;
+        JsonHelper::readLogTail(logPath, logOffset, lines);
+        if (start == 0 && !lines.empty()) logHead = lines.front();
+        for (const auto& line : lines) {
+            try {
+                applyLogRecord(nlohmann::json::parse(line));
+            }
+            catch (...) {
+                // 忽略损坏行
+            }
+        }
+        repl.lastSyncMs = nowMs();
+        return true;
+    }
+
+    ReplicationStatus replicationStatus() const {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        return repl;
+    }
+
+    StudentManager(const StudentManager&) = delete;
+    StudentManager& operator=(const StudentManager&) = delete;
+
+    // ========== 批量事务：暂存录入/删除/修改，commit 时整体生效 ==========
+    class Transaction {
+    public:
+        explicit Transaction(StudentManager& mgr) : mgr(mgr) {}
+
+        void add(const Student& stu) {
+            ops.push_back({ Mutation::Type::Add, stu });
+        }
+
+        void remove(const std::string& xh) {
+            Mutation m;
+            m.type = Mutation::Type::Delete;
+            m.stu.xh = xh;
+            ops.push_back(m);
+        }
+
+        void update(const Student& stu) {
+            ops.push_back({ Mutation::Type::Update, stu });
+        }
+
+        size_t size() const { return ops.size(); }
+
+        // 全部成功或全部不生效；失败时 errMsg 指出第几条出错
+        bool commit(std::string& errMsg) {
+            if (ops.empty()) return true;
+            if (!mgr.commitMutations(ops, errMsg)) return false;
+            ops.clear();
+            return true;
+        }
+
+    private:
+        StudentManager& mgr;
+        std::vector<Mutation> ops;
+    };
+
+    Transaction beginTransaction() { return Transaction(*this); }
+
+    // ========== 快照读（MVCC）：固定版本的只读视图，按学号有序 ==========
+    // 只有快照可与写入并发读取；query / findByName / findByXh / pageFrom / lazy* 等读接口不加锁，
+    // 返回的引用也直接指向当前数据，只能在没有并发写入时调用
+    class Snapshot {
+    public:
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Student;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Student*;
+            using reference = const Student&;
+
+            const_iterator() = default;
+            explicit const_iterator(std::vector<const Student*>::const_iterator it) : it(it) {}
+
+            const Student& operator*() const { return **it; }
+            const Student* operator->() const { return *it; }
+            const_iterator& operator++() {
+                ++it;
+                return *this;
+            }
+            bool operator==(const const_iterator& o) const { return it == o.it; }
+            bool operator!=(const const_iterator& o) const { return it != o.it; }
+
+        private:
+            std::vector<const Student*>::const_iterator it;
+        };
+
+        Snapshot() = default;
+
+        uint64_t version() const { return ver; }
+        bool valid() const { return data != nullptr; }
+        size_t size() const { return data ? data->order.size() : 0; }
+        bool empty() const { return size() == 0; }
+        const_iterator begin() const { return data ? const_iterator(data->order.begin()) : const_iterator(); }
+        const_iterator end() const { return data ? const_iterator(data->order.end()) : const_iterator(); }
+
+    private:
+        friend class StudentManager;
+        Snapshot(uint64_t ver, std::shared_ptr<const SnapshotData> data)
+            : ver(ver), data(std::move(data)) {}
+
+        uint64_t ver = 0;
+        std::shared_ptr<const SnapshotData> data;
+    };
+
+    uint64_t currentVersion() const {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        return version;
+    }
+
+    // 打开当前版本的快照；同一版本的读者共享同一份数据，之后的写入不影响它
+    // 写锁内只共享行存储的块指针（O(块数)，不复制记录）；按学号排序在锁外进行，
+    // 其间的写入会先复制被共享的块，不会改动快照引用的块
+    Snapshot openSnapshot() const {
+        auto data = std::make_shared<SnapshotData>();
+        uint64_t ver;
+        size_t slots;
+        {
+            std::lock_guard<std::mutex> lock(writeMtx);
+            collectSnapshots();
+            auto it = snapshots.find(version);
+            if (it != snapshots.end()) {
+                if (auto shared = it->second.lock()) return Snapshot(version, shared);
+            }
+            ver = version;
+            slots = rows.slotCount();
+            data->chunks = rows.share();
+        }
+
+        data->order.reserve(slots);
+        for (size_t id = 0; id < slots; ++id) {
+            const RowStore::Chunk& c = *data->chunks[id / RowStore::CHUNK];
+            if (c.used[id % RowStore::CHUNK]) data->order.push_back(&c.records[id % RowStore::CHUNK]);
+        }
+        std::sort(data->order.begin(), data->order.end(),
+            [](const Student* a, const Student* b) { return a->xh < b->xh; });
+
+        // 其他读者可能已为同一版本建好快照：沿用先登记的那份
+        std::lock_guard<std::mutex> lock(writeMtx);
+        std::weak_ptr<const SnapshotData>& slot = snapshots[ver];
+        if (auto shared = slot.lock()) return Snapshot(ver, shared);
+        slot = data;
+        return Snapshot(ver, data);
+    }
+
+    // 打开指定版本：该版本必须仍被其他读者持有（否则已被回收）
+    bool openSnapshot(uint64_t ver, Snapshot& out, std::string& errMsg) const {
+        if (ver == currentVersion()) {
+            out = openSnapshot();
+            if (out.version() == ver) return true;
+        }
+        std::lock_guard<std::mutex> lock(writeMtx);
+        collectSnapshots();
+        auto it = snapshots.find(ver);
+        if (it != snapshots.end()) {
+            if (auto shared = it->second.lock()) {
+                out = Snapshot(ver, shared);
                 return true;
             }
         }
+        errMsg = "版本 " + std::to_string(ver) + " 不存在或已被回收";
         return false;
     }
 
-    // ========== FR-4: 按学号查找（用于修改） ==========
-    Student* findByXh(const std::string& xh) {
-        for (auto& pair : students) {
-            if (pair.second.xh == xh) return &pair.second;
+    // 当前仍被读者持有的版本数
+    size_t retainedVersions() const {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        collectSnapshots();
+        return snapshots.size();
+    }
+
+    // ========== FR-1/FR-2: 录入学生 ==========
+    bool addStudent(const Student& stu, std::string& errMsg) {
+        Transaction txn(*this);
+        txn.add(stu);
+        return txn.commit(errMsg);
+    }
+
+    // ========== FR-3: 按姓名查找（返回同名记录区间） ==========
+    NameRange findByName(std::string_view name) const {
+        if (frozen) {
+            auto list = frozen->rowsOfName(name);
+            return NameRange(rows, list.first, list.second);
+        }
+        const RowId* head = nameHead.find(name);  // O(1) 找到同名链表头
+        return NameRange(rows, nameNext, head ? *head : RowStore::NO_ROW);
+    }
+
+    // ========== FR-3: 按学号删除 ==========
+    bool deleteByXh(const std::string& xh) {
+        Transaction txn(*this);
+        txn.remove(xh);
+        std::string errMsg;
+        return txn.commit(errMsg);
+    }
+
+    // ========== FR-4: 按学号查找 / 修改 ==========
+    const Student* findByXh(std::string_view xh) const {
+        RowId id = rowOf(xh);
+        return id == RowStore::NO_ROW ? nullptr : &rows[id];
+    }
+
+    // 按学号整条替换（学号不可改），经由事务以维护索引和日志
+    bool updateStudent(const Student& stu, std::string& errMsg) {
+        Transaction txn(*this);
+        txn.update(stu);
+        return txn.commit(errMsg);
+    }
+
+    // ========== 按条件批量删除 / 修改：一遍选出命中记录，整批作为一次提交（一条日志、一遍更新索引） ==========
+    // q 中能走索引的条件先缩小候选，pred 再逐行判断；affected 为实际删除 / 修改的条数，失败时为 0 且数据不变
+    template <typename Pred>
+    bool eraseIf(const StudentQuery& q, Pred pred, size_t& affected, std::string& errMsg) {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        affected = 0;
+        std::vector<Mutation> ops;
+        QueryPlan p;
+        forEachMatch(q, p, [&](const Student& s) {
+            if (!pred(s)) return;
+            Mutation m;
+            m.type = Mutation::Type::Delete;
+            m.stu.xh = s.xh;
+            ops.push_back(std::move(m));
+        });
+        if (!commitLocked(ops, errMsg)) return false;
+        affected = ops.size();
+        return true;
+    }
+
+    template <typename Pred>
+    bool eraseIf(Pred pred, size_t& affected, std::string& errMsg) {
+        return eraseIf(StudentQuery(), pred, affected, errMsg);
+    }
+
+    // change 就地修改命中记录的副本（学号不可改）；修改后与原记录相同的不计入、不写日志
+    template <typename Pred, typename Change>
+    bool updateIf(const StudentQuery& q, Pred pred, Change change, size_t& affected, std::string& errMsg) {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        affected = 0;
+        std::vector<Mutation> ops;
+        bool xhChanged = false;
+        QueryPlan p;
+        forEachMatch(q, p, [&](const Student& s) {
+            if (xhChanged || !pred(s)) return;
+            Student next = s;
+            change(next);
+            if (next.xh != s.xh) {
+                xhChanged = true;
+                return;
+            }
+            if (next.xm == s.xm && next.xb == s.xb && next.nl == s.nl && next.zy == s.zy) return;
+            ops.push_back({ Mutation::Type::Update, std::move(next) });
+        });
+        if (xhChanged) {
+            errMsg = "批量修改不能更改学号";
+            return false;
+        }
+        if (!commitLocked(ops, errMsg)) return false;
+        affected = ops.size();
+        return true;
+    }
+
+    template <typename Pred, typename Change>
+    bool updateIf(Pred pred, Change change, size_t& affected, std::string& errMsg) {
+        return updateIf(StudentQuery(), pred, change, affected, errMsg);
+    }
+
+    // ========== 学年升级：全体年龄调整 + 按年级 / 年龄归档，作为一次提交 ==========
+    struct RolloverRules {
+        int ageDelta = 1;              // 全体年龄增量
+        std::string archiveXhBefore;   // 学号小于此值的归档（学号以入学年份开头，如 "2022" 即 2021 级及以前）；空表示不按年级
+        int archiveAgeAbove = 0;       // 调整后年龄超过此值的归档；0 表示不按年龄
+    };
+
+    struct RolloverResult {
+        size_t aged = 0;             // 调整了年龄的人数
+        size_t archived = 0;         // 移入归档文件的人数
+        bool archiveWritten = true;  // 归档文件是否已写入；失败时保存前会重试
+    };
+
+    // 预览：校验规则并计算将调整、归档的人数，不修改数据
+    bool previewRollover(const RolloverRules& rules, RolloverResult& result, std::string& errMsg) const {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        result = RolloverResult();
+        std::vector<Student> archived;
+        std::vector<Mutation> ops;
+        if (!writable(errMsg) || !planRollover(rules, archived, ops, errMsg)) return false;
+        result.archived = archived.size();
+        result.aged = rules.ageDelta != 0 ? rows.size() - archived.size() : 0;
+        return true;
+    }
+
+    // 归档的记录随删除与年龄调整写入同一条日志，提交后再追加到归档文件（JsonHelper::archivePathFor）
+    // 追加按批次号去重：归档文件写入失败或进程中断时，由保存前的重试或启动时的日志回放补写，不会重复
+    bool rollover(const RolloverRules& rules, RolloverResult& result, std::string& errMsg) {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        result = RolloverResult();
+        if (!writable(errMsg)) return false;
+        std::vector<Student> archived;
+        std::vector<Mutation> ops;
+        if (!planRollover(rules, archived, ops, errMsg)) return false;
+
+        nlohmann::json extra = nlohmann::json::object();
+        std::string batchId = std::to_string(nowMs()) + "-" + std::to_string(version + 1);
+        if (!archived.empty()) extra["archive"] = { { "batch", batchId }, { "students", archived } };
+        if (!commitLocked(ops, errMsg, extra)) return false;
+
+        result.archived = archived.size();
+        result.aged = rules.ageDelta != 0 ? rows.size() : 0;
+        if (!archived.empty()) {
+            pendingArchives.emplace_back(batchId, std::move(archived));
+            result.archiveWritten = flushArchives();
+        }
+        return true;
+    }
+
+private:
+    // 学年升级的归档记录（按学号有序）与整批变更；规则不合法或校验不通过时返回 false（调用方持有 writeMtx）
+    bool planRollover(const RolloverRules& rules, std::vector<Student>& archived, std::vector<Mutation>& ops,
+                      std::string& errMsg) const {
+        const std::string& before = rules.archiveXhBefore;
+        if (!before.empty() && (before.size() > 12 || !std::all_of(before.begin(), before.end(),
+                [](char c) { return c >= '0' && c <= '9'; }))) {
+            errMsg = "归档学号界限须为 1-12 位数字";
+            return false;
+        }
+
+        // 按学号有序索引取前段、按年龄桶取高龄段，两条规则的并集
+        std::vector<uint8_t> picked(rows.slotCount(), 0);
+        std::vector<RowId> archivedIds;
+        auto pick = [&](RowId id) {
+            if (picked[id]) return;
+            picked[id] = 1;
+            archivedIds.push_back(id);
+        };
+        if (!before.empty()) {
+            auto end = xhOrder.lower_bound(before);
+            for (auto it = xhOrder.begin(); it != end; ++it) pick(it->second);
+        }
+        if (rules.archiveAgeAbove > 0) {
+            for (int b = ageBucketOf(rules.archiveAgeAbove - rules.ageDelta + 1); b < AGE_BUCKETS; ++b) {
+                for (RowId id : ageBuckets[b]) {
+                    if (rows[id].nl + rules.ageDelta > rules.archiveAgeAbove) pick(id);
+                }
+            }
+        }
+
+        archived.clear();
+        ops.clear();
+        archived.reserve(archivedIds.size());
+        ops.reserve(archivedIds.size() + 1);
+        for (RowId id : archivedIds) archived.push_back(rows[id]);
+        std::sort(archived.begin(), archived.end(),
+            [](const Student& a, const Student& b) { return a.xh < b.xh; });
+        for (const auto& s : archived) {
+            Mutation m;
+            m.type = Mutation::Type::Delete;
+            m.stu.xh = s.xh;
+            ops.push_back(std::move(m));
         }
-        return nullptr;
+        if (rules.ageDelta != 0) {
+            Mutation m;
+            m.type = Mutation::Type::AgeShift;
+            m.delta = rules.ageDelta;
+            ops.push_back(m);
+        }
+        return checkMutations(ops, errMsg);
+    }
+
+    // 写出已提交、尚未写入归档文件的批次；全部写入返回 true（调用方持有 writeMtx）
+    bool flushArchives() {
+        std::string path = JsonHelper::archivePathFor(dataPath);
+        while (!pendingArchives.empty()) {
+            const auto& batch = pendingArchives.front();
+            if (!JsonHelper::appendArchive(path, batch.first, batch.second)) return false;
+            pendingArchives.erase(pendingArchives.begin());
+        }
+        return true;
     }
 
+public:
     // ========== FR-5: 按专业查询 ==========
     std::vector<Student> searchByZy(const std::string& zy) const {
+        StudentQuery q;
+        q.zy = zy;
+        return query(q);  // 经过查询缓存
+    }
+
+    // ========== 惰性查询：返回按需产出的区间，可继续 filter / map / take / count ==========
+    // 区间引用内部数据，增删改之后不得继续使用
+    LazyRange<AllRowsSource> lazyAll() const {
+        return LazyRange<AllRowsSource>(AllRowsSource(rows));
+    }
+
+    LazyRange<BitmapSource> lazyByZy(const std::string& zy) const {
+        return LazyRange<BitmapSource>(BitmapSource(rows, bitmapOf(zyBitmaps, zy)));
+    }
+
+    // 学号条件走有序索引，其次专业/性别位图，否则扫描全部行
+    LazyRange<QuerySource> lazyQuery(const StudentQuery& q) const {
+        if (q.xh) {
+            return LazyRange<QuerySource>(QuerySource(XhRangeSource(rows, xhOrder, *q.xh, *q.xh, ""), q));
+        }
+        if (q.xhPrefix || q.xhMin || q.xhMax) {
+            std::string prefix = q.xhPrefix ? *q.xhPrefix : "";
+            std::string from = q.xhMin && *q.xhMin > prefix ? *q.xhMin : prefix;
+            return LazyRange<QuerySource>(QuerySource(XhRangeSource(rows, xhOrder, from, q.xhMax, prefix), q));
+        }
+        if (q.zy) {
+            return LazyRange<QuerySource>(QuerySource(BitmapSource(rows, bitmapOf(zyBitmaps, *q.zy)), q));
+        }
+        if (q.xb) {
+            const RowBitmap* bits = bitmapOf(xbBitmaps, Validator::normalizeXb(*q.xb));
+            return LazyRange<QuerySource>(QuerySource(BitmapSource(rows, bits), q));
+        }
+        return LazyRange<QuerySource>(QuerySource(AllRowsSource(rows), q));
+    }
+
+    // ========== 位图组合计数：专业任一（为空不限）且性别匹配（为空不限），不生成结果行 ==========
+    size_t countByZyXb(const std::vector<std::string>& zys, const std::string& xb = "") const {
+        const RowBitmap* xbMap = nullptr;
+        if (!xb.empty()) {
+            xbMap = bitmapOf(xbBitmaps, Validator::normalizeXb(xb));
+            if (!xbMap) return 0;
+        }
+
+        std::vector<const RowBitmap*> zyMaps;
+        for (const auto& zy : zys) {
+            if (const RowBitmap* m = bitmapOf(zyBitmaps, zy)) zyMaps.push_back(m);
+        }
+        if (zys.empty()) return xbMap ? xbMap->count() : count();
+        if (zyMaps.empty()) return 0;
+        if (zyMaps.size() == 1) {
+            return xbMap ? RowBitmap::andCount(*zyMaps[0], *xbMap) : zyMaps[0]->count();
+        }
+
+        RowBitmap any = *zyMaps[0];
+        for (size_t i = 1; i < zyMaps.size(); ++i) any.orWith(*zyMaps[i]);
+        return xbMap ? RowBitmap::andCount(any, *xbMap) : any.count();
+    }
+
+    // ========== 组合查询：选择候选最少的索引，其余条件在候选集上逐行判断 ==========
+    // 结果按规范化条件缓存行号；相关索引未变更时直接按行号取当前记录
+    std::vector<Student> query(const StudentQuery& q, QueryPlan* plan = nullptr) const {
+        std::string key = QueryCache::keyOf(q);
+        QueryPlan p;
+        std::vector<RowId> ids;
         std::vector<Student> result;
-        for (const auto& pair : students) {
-            if (pair.second.zy == zy) result.push_back(pair.second);
+        {
+            std::lock_guard<std::mutex> lock(cacheMtx);
+            if (queryCache.lookup(key, gens, ids, p)) {
+                result.reserve(ids.size());
+                for (RowId id : ids) result.push_back(rows[id]);
+                p.fromCache = true;
+                if (plan) *plan = p;
+                return result;
+            }
+        }
+        forEachMatch(q, p, [&](const Student& s) {
+            ids.push_back(rowOf(s.xh));
+            result.push_back(s);
+        });
+        {
+            std::lock_guard<std::mutex> lock(cacheMtx);
+            queryCache.store(key, QueryCache::fieldsOf(q), gens, std::move(ids), p);
+        }
+        if (plan) *plan = p;
+        return result;
+    }
+
+    QueryCache::Stats queryCacheStats() const {
+        std::lock_guard<std::mutex> lock(cacheMtx);
+        return queryCache.stats();
+    }
+
+    void setQueryCacheCapacity(size_t n) {
+        std::lock_guard<std::mutex> lock(cacheMtx);
+        queryCache.setCapacity(n);
+    }
+
+    // 按执行计划逐条回调命中的记录（不复制），计划写入 p
+    template <typename Fn>
+    void forEachMatch(const StudentQuery& q, QueryPlan& p, Fn fn) const {
+        p = QueryPlan();
+        p.access = QueryPlan::Access::FullScan;
+        p.estimated = rows.size();
+
+        // 候选行数估算：学号唯一（0/1 行），姓名取同名人数
+        if (q.xh) {
+            p.access = QueryPlan::Access::XhIndex;
+            p.estimated = rowOf(*q.xh) != RowStore::NO_ROW ? 1 : 0;
+        }
+        if (q.xhPrefix || q.xhMin || q.xhMax) {
+            // 区间行数需逐个数，超过当前最优估算即停止
+            size_t n = 0;
+            forEachInXhRange(q, [&](const Student&) { return ++n <= p.estimated; });
+            if (n < p.estimated) {
+                p.access = QueryPlan::Access::XhRange;
+                p.estimated = n;
+            }
+        }
+        if (q.xm) {
+            size_t n = findByName(*q.xm).size();
+            if (n < p.estimated) {
+                p.access = QueryPlan::Access::NameIndex;
+                p.estimated = n;
+            }
+        }
+        // 专业 / 性别位图：两者都有时先按字求交
+        RowBitmap bitmapCandidates;
+        if (q.zy || q.xb) {
+            static const RowBitmap none;
+            const RowBitmap* zyMap = q.zy ? bitmapOf(zyBitmaps, *q.zy) : nullptr;
+            const RowBitmap* xbMap = q.xb ? bitmapOf(xbBitmaps, Validator::normalizeXb(*q.xb)) : nullptr;
+            if (q.zy && !zyMap) zyMap = &none;
+            if (q.xb && !xbMap) xbMap = &none;
+            size_t n = zyMap && xbMap ? RowBitmap::andCount(*zyMap, *xbMap)
+                : (zyMap ? zyMap->count() : xbMap->count());
+            if (n < p.estimated) {
+                p.access = QueryPlan::Access::BitmapIndex;
+                p.estimated = n;
+                bitmapCandidates = zyMap ? *zyMap : *xbMap;
+                if (zyMap && xbMap) bitmapCandidates.andWith(*xbMap);
+            }
+        }
+        // 缺省的一端不设界：0 号与 151 号桶里的异常年龄同样要被覆盖
+        int nlLo = q.nlMin ? *q.nlMin : INT_MIN;
+        int nlHi = q.nlMax ? *q.nlMax : INT_MAX;
+        if (q.nlMin || q.nlMax) {
+            size_t n = ageRangeEstimate(nlLo, nlHi);
+            if (n < p.estimated) {
+                p.access = QueryPlan::Access::AgeIndex;
+                p.estimated = n;
+            }
+        }
+
+        // 被索引满足的条件不再逐行判断
+        StudentQuery rest = q;
+        if (p.access == QueryPlan::Access::XhIndex) {
+            p.indexCond = "xh = " + *q.xh;
+            rest.xh.reset();
+        }
+        else if (p.access == QueryPlan::Access::XhRange) {
+            StudentQuery rangeOnly;
+            rangeOnly.xhPrefix = q.xhPrefix;
+            rangeOnly.xhMin = q.xhMin;
+            rangeOnly.xhMax = q.xhMax;
+            auto conds = rangeOnly.describe();
+            for (size_t i = 0; i < conds.size(); ++i) p.indexCond += (i ? " AND " : "") + conds[i];
+            rest.xhPrefix.reset();
+            rest.xhMin.reset();
+            rest.xhMax.reset();
+        }
+        else if (p.access == QueryPlan::Access::NameIndex) {
+            p.indexCond = "xm = " + *q.xm;
+            rest.xm.reset();
+        }
+        else if (p.access == QueryPlan::Access::BitmapIndex) {
+            StudentQuery bitmapOnly;
+            bitmapOnly.xb = q.xb;
+            bitmapOnly.zy = q.zy;
+            auto conds = bitmapOnly.describe();
+            p.indexCond = conds.size() == 2 ? conds[0] + " AND " + conds[1] : conds[0];
+            rest.xb.reset();
+            rest.zy.reset();
+        }
+        else if (p.access == QueryPlan::Access::AgeIndex) {
+            StudentQuery ageOnly;
+            ageOnly.nlMin = q.nlMin;
+            ageOnly.nlMax = q.nlMax;
+            p.indexCond = ageOnly.describe().front();
+            rest.nlMin.reset();
+            rest.nlMax.reset();
         }
+        p.residual = rest.describe();
+
+        auto examine = [&](const Student& s) {
+            ++p.rowsExamined;
+            if (!rest.matches(s)) return;
+            ++p.rowsMatched;
+            fn(s);
+        };
+        switch (p.access) {
+        case QueryPlan::Access::XhIndex:
+            if (const Student* s = findByXh(*q.xh)) examine(*s);
+            break;
+        case QueryPlan::Access::XhRange:
+            forEachInXhRange(q, [&](const Student& s) { examine(s); return true; });
+            break;
+        case QueryPlan::Access::NameIndex: {
+            for (const Student& s : findByName(*q.xm)) examine(s);
+            break;
+        }
+        case QueryPlan::Access::BitmapIndex:
+            bitmapCandidates.forEach([&](RowId id) { examine(rows[id]); });
+            break;
+        case QueryPlan::Access::AgeIndex:
+            forEachInAgeRange(nlLo, nlHi, examine);
+            break;
+        case QueryPlan::Access::FullScan:
+            rows.forEach([&](RowId, const Student& s) { examine(s); });
+            break;
+        }
+    }
+
+    // ========== 多键排序 + LIMIT：有界堆只保留前 limit 条，O(n log k) ==========
+    // limit 为 0 表示不限（退化为完整排序）；学号作为最终排序键保证结果确定
+    std::vector<Student> topK(const StudentQuery& q, const std::vector<OrderKey>& order, size_t limit,
+                              QueryPlan* plan = nullptr) const {
+        return topKWhere(q, [](const Student&) { return true; }, order, limit, plan);
+    }
+
+    // 同 topK，另加一个逐行判断的附加条件（索引无法覆盖的条件）
+    template <typename Pred>
+    std::vector<Student> topKWhere(const StudentQuery& q, Pred pred, const std::vector<OrderKey>& order,
+                                   size_t limit, QueryPlan* plan = nullptr) const {
+        StudentOrder less{ order };
+        if (std::none_of(order.begin(), order.end(), [](const OrderKey& k) { return k.field == OrderKey::Field::Xh; })) {
+            less.keys.push_back({ OrderKey::Field::Xh, false });
+        }
+        auto ptrLess = [&](const Student* a, const Student* b) { return less(*a, *b); };
+
+        QueryPlan p;
+        std::vector<const Student*> heap;  // 大顶堆：堆顶是已保留记录中排序最靠后的一条
+        forEachMatch(q, p, [&](const Student& s) {
+            if (!pred(s)) return;
+            if (limit == 0 || heap.size() < limit) {
+                heap.push_back(&s);
+                if (limit) std::push_heap(heap.begin(), heap.end(), ptrLess);
+            }
+            else if (less(s, *heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), ptrLess);
+                heap.back() = &s;
+                std::push_heap(heap.begin(), heap.end(), ptrLess);
+            }
+        });
+        if (limit) std::sort_heap(heap.begin(), heap.end(), ptrLess);
+        else std::sort(heap.begin(), heap.end(), ptrLess);
+
+        std::vector<Student> result;
+        result.reserve(heap.size());
+        for (const Student* s : heap) result.push_back(*s);
+        if (plan) *plan = p;
         return result;
     }
 
+    // ========== 学号区间 / 前缀查询：结果按学号有序 ==========
+    std::vector<Student> findByXhRange(const std::string& lo, const std::string& hi) const {
+        StudentQuery q;
+        q.xhMin = lo;
+        q.xhMax = hi;
+        std::vector<Student> result;
+        forEachInXhRange(q, [&](const Student& s) { result.push_back(s); return true; });
+        return result;
+    }
+
+    std::vector<Student> findByXhPrefix(const std::string& prefix) const {
+        StudentQuery q;
+        q.xhPrefix = prefix;
+        std::vector<Student> result;
+        forEachInXhRange(q, [&](const Student& s) { result.push_back(s); return true; });
+        return result;
+    }
+
+    // ========== 姓名模糊检索：前缀 / 包含，完全相同 > 前缀 > 包含 ==========
+    std::vector<Student> searchByNamePrefix(const std::string& prefix, size_t limit = 50) const {
+        return expandNames(nameSearch.prefix(prefix, limit), limit);
+    }
+
+    std::vector<Student> searchByNameSubstring(const std::string& pat, size_t limit = 50) const {
+        return expandNames(nameSearch.contains(pat, limit), limit);
+    }
+
+    // ========== 年龄区间查询与直方图（由年龄桶直接回答） ==========
+    std::vector<Student> findByAgeRange(int lo, int hi) const {
+        std::vector<Student> result;
+        result.reserve(ageRangeEstimate(lo, hi));
+        forEachInAgeRange(lo, hi, [&](const Student& s) { result.push_back(s); });
+        return result;
+    }
+
+    size_t countByAgeRange(int lo, int hi) const {
+        if (lo <= 0 || hi >= AGE_BUCKETS - 1) {
+            size_t n = 0;
+            forEachInAgeRange(lo, hi, [&](const Student&) { ++n; });
+            return n;
+        }
+        return ageRangeEstimate(lo, hi);  // 不含异常值桶时桶大小即精确计数
+    }
+
+    // 年龄 → 人数，只含人数非零的年龄
+    std::map<int, size_t> ageHistogram() const {
+        std::map<int, size_t> hist;
+        for (int b = 1; b < AGE_BUCKETS - 1; ++b) {
+            if (!ageBuckets[b].empty()) hist[b] = ageBuckets[b].size();
+        }
+        for (int b : { 0, AGE_BUCKETS - 1 }) {
+            for (RowId id : ageBuckets[b]) ++hist[rows[id].nl];
+        }
+        return hist;
+    }
+
+    // ========== 统计（增量维护，O(1)） ==========
+    size_t countOfZy(std::string_view zy) const {
+        const RowBitmap* bits = bitmapOf(zyBitmaps, zy);
+        return bits ? bits->count() : 0;
+    }
+
+    size_t countOfXb(const std::string& xb) const {
+        const RowBitmap* bits = bitmapOf(xbBitmaps, Validator::normalizeXb(xb));
+        return bits ? bits->count() : 0;
+    }
+
+    size_t countOfZyXb(const std::string& zy, const std::string& xb) const {
+        auto it = zyXbCounts.find(zyXbKey(zy, xb));
+        return it == zyXbCounts.end() ? 0 : it->second;
+    }
+
+    uint64_t ageSum() const { return nlSum; }
+    double averageAge() const { return rows.size() == 0 ? 0.0 : static_cast<double>(nlSum) / rows.size(); }
+
+    // ========== 学号分组：按分段（默认 年级4位/学院2位/班级2位）维护的分组统计 ==========
+    const std::vector<IdSegment>& getCohortSegments() const { return cohortIndex.getSegments(); }
+
+    // 更换分段定义并重建分组
+    void setCohortSegments(const std::vector<IdSegment>& segs) {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        cohortIndex.setSegments(segs);
+        rows.forEach([&](RowId id, const Student& s) { cohortIndex.add(id, s); });
+    }
+
+    // 学号所属分组键，如 "2023-05-02"
+    std::string cohortKeyOf(const std::string& xh) const { return cohortIndex.keyOf(xh); }
+
+    // 分组统计（人数、平均年龄、年龄/专业分布），不存在返回 nullptr
+    const Cohort* findCohort(const std::string& key) const { return cohortIndex.find(key); }
+
+    size_t countOfCohort(const std::string& key) const {
+        const Cohort* c = cohortIndex.find(key);
+        return c ? c->count() : 0;
+    }
+
+    std::vector<Student> cohortMembers(const std::string& key) const {
+        std::vector<Student> result;
+        if (const Cohort* c = cohortIndex.find(key)) {
+            result.reserve(c->count());
+            c->members.forEach([&](RowId id) { result.push_back(rows[id]); });
+        }
+        return result;
+    }
+
+    // 键以 prefix 开头的分组（如 "2023" 列出该年级全部班级），按键有序
+    std::vector<std::string> cohortsWithPrefix(const std::string& prefix = "") const {
+        std::vector<std::string> keys;
+        cohortIndex.forEachWithPrefix(prefix, [&](const std::string& key, const Cohort&) { keys.push_back(key); });
+        return keys;
+    }
+
+    // ========== 年龄聚合：在年龄列上向量化计算 count/min/max/mean ==========
+    AgeStats ageStats(int lo = 1, int hi = 150) const {
+        return AgeKernels::aggregate(ageCol.data(), ageCol.size(), lo, hi);
+    }
+
+    // 某专业的年龄统计：专业位图作为行掩码
+    AgeStats ageStatsByZy(const std::string& zy, int lo = 1, int hi = 150) const {
+        const RowBitmap* bits = bitmapOf(zyBitmaps, zy);
+        if (!bits) return AgeStats();
+        return AgeKernels::aggregateMasked(ageCol.data(), ageCol.size(), bits->data(), bits->wordCount(), lo, hi);
+    }
+
+    // 各专业年龄统计（如平均年龄），只含有学生的专业
+    std::map<std::string, AgeStats> ageStatsPerMajor(int lo = 1, int hi = 150) const {
+        std::map<std::string, AgeStats> result;
+        for (const auto& kv : zyBitmaps) {
+            if (kv.second.empty()) continue;
+            result[kv.first] = ageStatsByZy(kv.first, lo, hi);
+        }
+        return result;
+    }
+
+    // ========== 分页：按学号有序的游标翻页，只取出当前页 ==========
+    // 学号 >= xh 的第一页（xh 为空则从头开始），用于首页与按学号跳转
+    Page pageFrom(const std::string& xh, size_t pageSize, const StudentQuery* filter = nullptr) const {
+        return scanForward(xhOrder.lower_bound(xh), pageSize, filter);
+    }
+
+    Page nextPage(const Page& cur, size_t pageSize, const StudentQuery* filter = nullptr) const {
+        if (cur.rows.empty()) return pageFrom("", pageSize, filter);
+        return scanForward(xhOrder.upper_bound(cur.lastXh()), pageSize, filter);
+    }
+
+    Page prevPage(const Page& cur, size_t pageSize, const StudentQuery* filter = nullptr) const {
+        if (cur.rows.empty()) return pageFrom("", pageSize, filter);
+        // 从本页首条之前倒序取满一页，再翻回正序
+        Page page;
+        auto it = xhOrder.lower_bound(cur.firstXh());
+        while (it != xhOrder.begin() && page.rows.size() < pageSize) {
+            --it;
+            const Student& s = rows[it->second];
+            if (!filter || filter->matches(s)) page.rows.push_back(s);
+        }
+        if (page.rows.size() < pageSize) return pageFrom("", pageSize, filter);  // 已到开头
+        std::reverse(page.rows.begin(), page.rows.end());
+        page.hasNext = true;
+        page.hasPrev = hasMatchBefore(it, filter);
+        return page;
+    }
+
     // ========== FR-6: 显示全部（按学号排序） ==========
     void displayAll() const {
-        if (students.empty()) {
+        // 基于快照输出：已按学号排序，且不受并发写入影响
+        Snapshot sorted = openSnapshot();
+        if (sorted.empty()) {
             std::cout << "暂无学生数据\n";
             return;
         }
 
-        // 提取并按学号排序
-        std::vector<Student> sorted;
-        sorted.reserve(students.size());
-        for (const auto& pair : students) {
-            sorted.push_back(pair.second);
-        }
-        std::sort(sorted.begin(), sorted.end(),
-            [](const Student& a, const Student& b) { return a.xh < b.xh; });
-
         // 表格输出
         std::cout << std::left
             << std::setw(14) << "学号"
@@ -132,6 +1714,13 @@ public:
         }
     }
 
-    bool save() { return JsonHelper::save(students); }
-    size_t count() const { return students.size(); }
+    // 保存快照，成功后清空变更日志
+    bool save() {
+        std::lock_guard<std::mutex> lock(writeMtx);
+        if (readOnly) return false;
+        if (!flushArchives()) return false;  // 日志清空前归档须已落盘
+        std::string saveId = std::to_string(nowMs()) + "-" + std::to_string(version);
+        return JsonHelper::save(dataPath, sortedRecords(), journalSeq) && JsonHelper::clearLog(logPath, saveId);
+    }
+    size_t count() const { return rows.size(); }
 };
\ No newline at end of file
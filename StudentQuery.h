@@ -0,0 +1,119 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <optional>
+#include "Student.h"
+#include "Validator.h"
+
+// 组合查询条件：已设置的字段全部满足才命中（AND），未设置的字段不参与过滤
+struct StudentQuery {
+    std::optional<std::string> xh;  // 学号 =
+    std::optional<std::string> xhPrefix;  // 学号以此开头（如入学年份 2023）
+    std::optional<std::string> xhMin;     // 学号 >=（学号定长 12 位，字典序即数值序）
+    std::optional<std::string> xhMax;     // 学号 <=
+    std::optional<std::string> xm;  // 姓名 =
+    std::optional<std::string> xb;  // 性别 =（男/M/m 视为同一值，女/F/f 同理）
+    std::optional<int> nlMin;       // 年龄 >=
+    std::optional<int> nlMax;       // 年龄 <=
+    std::optional<std::string> zy;  // 专业 =
+
+    bool matches(const Student& s) const {
+        if (xh && s.xh != *xh) return false;
+        if (xhPrefix && s.xh.compare(0, xhPrefix->size(), *xhPrefix) != 0) return false;
+        if (xhMin && s.xh < *xhMin) return false;
+        if (xhMax && s.xh > *xhMax) return false;
+        if (xm && s.xm != *xm) return false;
+        if (xb && Validator::normalizeXb(s.xb) != Validator::normalizeXb(*xb)) return false;
+        if (nlMin && s.nl < *nlMin) return false;
+        if (nlMax && s.nl > *nlMax) return false;
+        if (zy && s.zy != *zy) return false;
+        return true;
+    }
+
+    // 各条件的文字描述（用于执行计划输出）
+    std::vector<std::string> describe() const {
+        std::vector<std::string> parts;
+        if (xh) parts.push_back("xh = " + *xh);
+        if (xhPrefix) parts.push_back("xh LIKE " + *xhPrefix + "%");
+        if (xhMin) parts.push_back("xh >= " + *xhMin);
+        if (xhMax) parts.push_back("xh <= " + *xhMax);
+        if (xm) parts.push_back("xm = " + *xm);
+        if (xb) parts.push_back("xb = " + Validator::normalizeXb(*xb));
+        if (nlMin && nlMax) parts.push_back("nl " + std::to_string(*nlMin) + "-" + std::to_string(*nlMax));
+        else if (nlMin) parts.push_back("nl >= " + std::to_string(*nlMin));
+        else if (nlMax) parts.push_back("nl <= " + std::to_string(*nlMax));
+        if (zy) parts.push_back("zy = " + *zy);
+        return parts;
+    }
+};
+
+// 排序键：字段 + 升/降序
+struct OrderKey {
+    enum class Field { Xh, Xm, Xb, Nl, Zy };
+
+    Field field = Field::Xh;
+    bool desc = false;
+};
+
+// 多键比较器：依次比较各键，前一键相等才看下一键
+struct StudentOrder {
+    std::vector<OrderKey> keys;
+
+    bool operator()(const Student& a, const Student& b) const {
+        for (const auto& k : keys) {
+            int c = compare(a, b, k.field);
+            if (c != 0) return k.desc ? c > 0 : c < 0;
+        }
+        return false;
+    }
+
+    static int compare(const Student& a, const Student& b, OrderKey::Field f) {
+        switch (f) {
+        case OrderKey::Field::Xh: return a.xh.compare(b.xh);
+        case OrderKey::Field::Xm: return a.xm.compare(b.xm);
+        case OrderKey::Field::Xb: return Validator::normalizeXb(a.xb).compare(Validator::normalizeXb(b.xb));
+        case OrderKey::Field::Nl: return a.nl < b.nl ? -1 : (a.nl > b.nl ? 1 : 0);
+        case OrderKey::Field::Zy: return a.zy.compare(b.zy);
+        }
+        return 0;
+    }
+};
+
+// 执行计划：选用的访问路径与实际检查的行数
+struct QueryPlan {
+    enum class Access { XhIndex, XhRange, NameIndex, BitmapIndex, AgeIndex, FullScan };
+
+    Access access = Access::FullScan;
+    std::string indexCond;               // 由索引直接满足的条件
+    std::vector<std::string> residual;   // 在候选集上逐行判断的其余条件
+    size_t estimated = 0;                // 选择索引时估算的候选行数
+    size_t rowsExamined = 0;             // 实际检查的行数
+    size_t rowsMatched = 0;
+    bool fromCache = false;              // 结果取自查询缓存（其余字段为首次执行时的计划）
+
+    static const char* accessName(Access a) {
+        switch (a) {
+        case Access::XhIndex:   return "学号索引";
+        case Access::XhRange:   return "学号有序索引";
+        case Access::NameIndex: return "姓名索引";
+        case Access::BitmapIndex: return "专业/性别位图";
+        case Access::AgeIndex:  return "年龄桶索引";
+        case Access::FullScan:  return "全表扫描";
+        }
+        return "";
+    }
+
+    std::string explain() const {
+        std::string out = std::string("访问路径: ") + accessName(access);
+        if (!indexCond.empty()) out += " (" + indexCond + ")";
+        out += "\n估算候选: " + std::to_string(estimated) + " 行\n剩余条件: ";
+        if (residual.empty()) out += "无";
+        for (size_t i = 0; i < residual.size(); ++i) {
+            out += (i ? ", " : "") + residual[i];
+        }
+        out += "\n检查行数: " + std::to_string(rowsExamined)
+            + "，命中: " + std::to_string(rowsMatched) + "\n";
+        if (fromCache) out += "（结果取自查询缓存）\n";
+        return out;
+    }
+};
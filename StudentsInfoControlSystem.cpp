@@ -1,8 +1,18 @@
 ﻿#include "MenuHandler.h"
+#include "ShardWorker.h"
+#include "Benchmark.h"
 #include <windows.h>
 #include <iostream>
+#include <string>
+#include <fstream>
+#include <cstdlib>
 
-int main() {
+// 用法: StudentsInfoControlSystem.exe [--follower [数据文件]]
+//       StudentsInfoControlSystem.exe --query "SELECT ... / UPDATE ... / DELETE ..."
+//       StudentsInfoControlSystem.exe --script 语句文件（每行一条，-- 开头为注释）
+//       StudentsInfoControlSystem.exe --shard-worker 分片数据文件（由 ShardedStudentManager 启动，经管道收发请求）
+//       StudentsInfoControlSystem.exe --bench [记录数，默认 200000]
+int main(int argc, char* argv[]) {
     // 设置控制台代码页为 UTF-8（解决中文乱码）
     SetConsoleOutputCP(65001);  // 输出 UTF-8
     SetConsoleCP(65001);        // 输入 UTF-8
@@ -10,6 +20,45 @@ int main() {
     // 确保 C++ 流使用正确编码
     std::ios::sync_with_stdio(false);
     
+    // 只读跟随：与主进程共用数据文件，分担查询负载
+    if (argc >= 2 && std::string(argv[1]) == "--follower") {
+        MenuHandler::runFollower(argc >= 3 ? argv[2] : JsonHelper::defaultDataPath());
+        return 0;
+    }
+
+    // 分片工作进程：标准输入/输出为与协调进程之间的管道
+    if (argc >= 3 && std::string(argv[1]) == "--shard-worker") {
+        return ShardWorker::serve(argv[2], std::cin, std::cout);
+    }
+
+    // 性能对比：新旧实现在同一批生成数据上计时
+    if (argc >= 2 && std::string(argv[1]) == "--bench") {
+        Benchmark::runAll(argc >= 3 ? std::strtoul(argv[2], nullptr, 10) : 200000);
+        return 0;
+    }
+
+    // 脚本模式：只执行语句（查询或按条件批量修改），不进入菜单
+    if (argc >= 3 && std::string(argv[1]) == "--query") {
+        return MenuHandler::runStatement(StudentManager::getInstance(), argv[2]) ? 0 : 1;
+    }
+    if (argc >= 3 && std::string(argv[1]) == "--script") {
+        std::ifstream in(argv[2]);
+        if (!in) {
+            std::cout << "× 无法打开脚本文件: " << argv[2] << "\n";
+            return 1;
+        }
+        auto& mgr = StudentManager::getInstance();
+        bool ok = true;
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string::npos || line.compare(start, 2, "--") == 0) continue;
+            std::cout << "SQL> " << line.substr(start) << "\n";
+            ok = MenuHandler::runStatement(mgr, line) && ok;
+        }
+        return ok ? 0 : 1;
+    }
+
     MenuHandler::run();
     return 0;
 }
\ No newline at end of file
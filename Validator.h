@@ -55,6 +55,13 @@ public:
             xb == "M" || xb == "m" || xb == "F" || xb == "f";
     }
 
+    // 性别归一化：M/m → 男，F/f → 女，其余原样返回（用于查询与统计）
+    static std::string normalizeXb(const std::string& xb) {
+        if (xb == "M" || xb == "m") return "男";
+        if (xb == "F" || xb == "f") return "女";
+        return xb;
+    }
+
     // 获取有效专业列表
     static const std::vector<std::string>& getValidMajors() {
         static std::vector<std::string> majors = {